@@ -0,0 +1,99 @@
+#include "Arena.h"
+
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+size_t RoundUp(size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+}
+
+Arena::Arena(size_t bytes, bool useHugePages, bool prefault)
+    : base{nullptr}, capacity{0}, used{0}, fallbacks{0}, hugePages{false} {
+    freeLists.fill(nullptr);
+    if (bytes == 0) {
+        return;
+    }
+
+    void* region = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Explicit huge pages need a reserved pool; fall back quietly without one
+    if (useHugePages) {
+        capacity = RoundUp(bytes, HugePageSize);
+        region = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugePages = region != MAP_FAILED;
+    }
+#endif
+    if (region == MAP_FAILED) {
+        capacity = RoundUp(bytes, useHugePages ? HugePageSize : static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        region = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            throw std::runtime_error("Arena could not reserve " + std::to_string(capacity) + " bytes");
+        }
+#ifdef MADV_HUGEPAGE
+        if (useHugePages) {
+            madvise(region, capacity, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    base = static_cast<std::byte*>(region);
+
+    if (prefault) {
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        for (size_t offset = 0; offset < capacity; offset += pageSize) {
+            static_cast<volatile std::byte*>(base)[offset] = std::byte{0};
+        }
+    }
+}
+
+Arena::~Arena() {
+    if (base) {
+        munmap(base, capacity);
+    }
+}
+
+void* Arena::Allocate(size_t bytes) {
+    size_t rounded = RoundUp(bytes == 0 ? 1 : bytes, Alignment);
+    size_t sizeClass = rounded / Alignment - 1;
+    if (sizeClass < SmallClasses && freeLists[sizeClass]) {
+        FreeBlock* block = freeLists[sizeClass];
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+    if (used + rounded <= capacity) {
+        void* block = base + used;
+        used += rounded;
+        return block;
+    }
+    ++fallbacks;
+    return ::operator new(rounded);
+}
+
+// Small blocks go back on their free list; large blocks are only reclaimed
+// when they were the most recent bump allocation
+void Arena::Deallocate(void* pointer, size_t bytes) {
+    if (!Owns(pointer)) {
+        ::operator delete(pointer);
+        return;
+    }
+    size_t rounded = RoundUp(bytes == 0 ? 1 : bytes, Alignment);
+    size_t sizeClass = rounded / Alignment - 1;
+    if (sizeClass < SmallClasses) {
+        freeLists[sizeClass] = new (pointer) FreeBlock{freeLists[sizeClass]};
+    } else if (static_cast<std::byte*>(pointer) + rounded == base + used) {
+        used -= rounded;
+    }
+}
+
+bool Arena::Owns(const void* pointer) const {
+    auto* address = static_cast<const std::byte*>(pointer);
+    return base && address >= base && address < base + capacity;
+}
+
+size_t Arena::Capacity() const { return capacity; }
+size_t Arena::Used() const { return used; }
+size_t Arena::FallbackAllocations() const { return fallbacks; }
+bool Arena::HugePages() const { return hugePages; }
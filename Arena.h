@@ -0,0 +1,91 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+// Fixed-size memory region reserved up front for one orderbook's nodes.
+// Small blocks are recycled through per-size free lists, so node churn in
+// steady state never returns to the system allocator; large blocks are
+// bump-allocated. Requests that no longer fit fall back to operator new.
+// Not thread-safe: each book (and each thread) owns its own arena.
+class Arena {
+public:
+    // Optionally backed by huge pages; prefaulting touches every page now
+    // instead of on first use
+    Arena(size_t bytes, bool hugePages, bool prefault);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(size_t bytes);
+    void Deallocate(void* pointer, size_t bytes);
+    bool Owns(const void* pointer) const;
+
+    size_t Capacity() const;
+    size_t Used() const;
+    size_t FallbackAllocations() const;
+    bool HugePages() const;
+
+    static constexpr size_t Alignment = 16;
+
+private:
+    static constexpr size_t SmallClasses = 16; // 16..256 bytes
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::byte* base;
+    size_t capacity;
+    size_t used;
+    size_t fallbacks;
+    bool hugePages;
+    std::array<FreeBlock*, SmallClasses> freeLists;
+};
+
+// Standard allocator over an Arena; a null arena means the global heap
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static_assert(alignof(T) <= Arena::Alignment, "arena blocks are 16-byte aligned");
+
+    explicit ArenaAllocator(Arena* arena = nullptr) noexcept : arena{arena} {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena{other.arena} {}
+
+    T* allocate(size_t n) {
+        if (!arena) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t n) noexcept {
+        if (!arena) {
+            ::operator delete(pointer);
+            return;
+        }
+        arena->Deallocate(pointer, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    Arena* arena;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,277 @@
+#include "Backtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+namespace {
+// One bar spanning the whole session gives its high and low
+constexpr Timestamp SessionInterval = Timestamp{1} << 62;
+
+bool ParseSide(const std::string& text, BuyOrSell& side) {
+    if (text == "buy") {
+        side = BuyOrSell::Buy;
+    } else if (text == "sell") {
+        side = BuyOrSell::Sell;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Applies one session-file event; false when the line does not parse
+bool ApplyEvent(Orderbook& orderbook, const std::string& action, std::istringstream& fields, SessionResult& result) {
+    if (action == "add") {
+        OrderId orderId;
+        std::string sideText;
+        BuyOrSell side;
+        Price price;
+        Quantity quantity;
+        if (!(fields >> orderId >> sideText >> price >> quantity) || !ParseSide(sideText, side)) {
+            return false;
+        }
+        OrderType orderType = OrderType::GoodTillCancel;
+        Timestamp expiry = 0;
+        std::string typeText;
+        if (fields >> typeText) {
+            if (typeText == "FAK") {
+                orderType = OrderType::FillAndKill;
+            } else if (typeText == "GFD") {
+                orderType = OrderType::GoodForDay;
+            } else if (typeText == "GTT" && fields >> expiry) {
+                orderType = OrderType::GoodTillTime;
+            } else if (typeText != "GTC") {
+                return false;
+            }
+        }
+        orderbook.AddOrder(std::make_shared<Order>(orderType, orderId, side, price, quantity, expiry));
+        ++result.ordersAdded;
+    } else if (action == "cancel") {
+        OrderId orderId;
+        if (!(fields >> orderId)) {
+            return false;
+        }
+        orderbook.CancelOrder(orderId);
+        ++result.cancels;
+    } else if (action == "modify") {
+        OrderId orderId;
+        std::string sideText;
+        BuyOrSell side;
+        Price price;
+        Quantity quantity;
+        if (!(fields >> orderId >> sideText >> price >> quantity) || !ParseSide(sideText, side)) {
+            return false;
+        }
+        orderbook.MatchOrder(OrderModify(orderId, side, price, quantity));
+    } else if (action == "time") {
+        Timestamp now;
+        if (!(fields >> now)) {
+            return false;
+        }
+        orderbook.AdvanceTime(now);
+    } else if (action == "session") {
+        Timestamp close;
+        if (!(fields >> close)) {
+            return false;
+        }
+        orderbook.SetSessionClose(close);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ReplayFile(Orderbook& orderbook, const std::string& path, SessionResult& result) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::string event = line.substr(0, line.find('#'));
+        std::istringstream fields(event);
+        std::string action;
+        if (!(fields >> action)) {
+            continue;
+        }
+        ++result.events;
+        if (!ApplyEvent(orderbook, action, fields, result)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": cannot parse '" + line + "'");
+        }
+    }
+}
+
+// Synthetic flow around a slowly wandering mid: mostly passive orders a few
+// ticks away, some marketable ones, and cancel-heavy churn
+void ReplaySeed(Orderbook& orderbook, uint64_t seed, size_t events, SessionResult& result) {
+    std::mt19937_64 rng(seed);
+    const Price tick = 0.01L;
+    int64_t mid = 10000;
+    Timestamp now = 0;
+    OrderId nextId = 1;
+    std::vector<OrderId> live;
+
+    for (size_t event = 0; event < events; ++event) {
+        ++result.events;
+        now += 1 + rng() % 3;
+        if (event % 64 == 0) {
+            orderbook.AdvanceTime(now);
+        }
+        if (event % 128 == 0) {
+            mid += static_cast<int64_t>(rng() % 3) - 1;
+        }
+
+        // Forget orders that have since filled or expired
+        if (live.size() > 4096) {
+            live.erase(std::remove_if(live.begin(), live.end(),
+                                      [&orderbook](OrderId orderId) { return !orderbook.FindOrder(orderId); }),
+                       live.end());
+        }
+
+        unsigned roll = rng() % 100;
+        if (roll < 45 && !live.empty()) {
+            size_t pick = rng() % live.size();
+            orderbook.CancelOrder(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+            ++result.cancels;
+            continue;
+        }
+        BuyOrSell side = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+        int64_t offset = static_cast<int64_t>(rng() % 12) - 2; // Below zero crosses the mid
+        Price price = static_cast<Price>(side == BuyOrSell::Buy ? mid - offset : mid + offset) * tick;
+        Quantity quantity = static_cast<Quantity>(1 + rng() % 100);
+        if (roll < 50 && !live.empty()) {
+            size_t pick = rng() % live.size();
+            if (OrderPointer order = orderbook.FindOrder(live[pick])) {
+                orderbook.MatchOrder(OrderModify(live[pick], order->GetBuyOrSell(), price, quantity));
+            }
+            continue;
+        }
+
+        OrderType orderType = roll < 55 ? OrderType::FillAndKill : roll < 60 ? OrderType::GoodTillTime : OrderType::GoodTillCancel;
+        Timestamp expiry = orderType == OrderType::GoodTillTime ? now + 1 + rng() % 5000 : 0;
+        orderbook.AddOrder(std::make_shared<Order>(orderType, nextId, side, price, quantity, expiry));
+        ++result.ordersAdded;
+        if (orderType != OrderType::FillAndKill) {
+            live.push_back(nextId);
+        }
+        ++nextId;
+    }
+}
+}
+
+SessionSource SessionSource::FromFile(const std::string& path) { return SessionSource{path, 0}; }
+SessionSource SessionSource::FromSeed(uint64_t seed) { return SessionSource{"", seed}; }
+std::string SessionSource::Name() const { return path.empty() ? "seed " + std::to_string(seed) : path; }
+
+SessionResult RunSession(const SessionSource& source, const BacktestConfig& config) {
+    SessionResult result;
+    result.name = source.Name();
+    auto start = std::chrono::steady_clock::now();
+    try {
+        Orderbook orderbook(config.capacity, config.band);
+        orderbook.SetDiagnostics(nullptr);
+        orderbook.GetBarAggregator().AddInterval(SessionInterval);
+        if (source.path.empty()) {
+            ReplaySeed(orderbook, source.seed, config.eventsPerSeed, result);
+        } else {
+            ReplayFile(orderbook, source.path, result);
+        }
+        result.restingOrders = orderbook.Size();
+        result.statistics = orderbook.GetTradeStatistics();
+        Bar session;
+        if (orderbook.GetBarAggregator().CurrentBar(SessionInterval, session)) {
+            result.high = session.high;
+            result.low = session.low;
+        }
+    }
+    catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+BacktestSummary RunBacktest(const std::vector<SessionSource>& sources, const BacktestConfig& config) {
+    BacktestSummary summary;
+    summary.sessions.resize(sources.size());
+    auto start = std::chrono::steady_clock::now();
+    {
+        // No point in more workers than sessions
+        size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        ThreadPool pool(std::max<size_t>(1, std::min(threads, sources.size())));
+        summary.threads = pool.Size();
+
+        // Each session writes only its own slot, so results need no locking
+        for (size_t index = 0; index < sources.size(); ++index) {
+            pool.Submit([&summary, &sources, &config, index] {
+                summary.sessions[index] = RunSession(sources[index], config);
+            });
+        }
+        pool.Wait();
+        summary.steals = pool.Steals();
+    }
+    summary.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long double notional = 0;
+    bool traded = false;
+    for (const SessionResult& session : summary.sessions) {
+        summary.events += session.events;
+        summary.sessionSeconds += session.seconds;
+        if (!session.error.empty()) {
+            ++summary.failed;
+            continue;
+        }
+        const TradeStatistics& statistics = session.statistics;
+        summary.trades += statistics.tradeCount;
+        summary.volume += statistics.volume;
+        notional += statistics.vwap * static_cast<long double>(statistics.volume);
+        if (statistics.tradeCount > 0) {
+            summary.high = traded ? std::max(summary.high, session.high) : session.high;
+            summary.low = traded ? std::min(summary.low, session.low) : session.low;
+            traded = true;
+        }
+    }
+    summary.vwap = summary.volume ? notional / summary.volume : 0;
+    return summary;
+}
+
+void PrintBacktestReport(std::ostream& out, const BacktestSummary& summary, bool perSession) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    if (perSession) {
+        for (const SessionResult& session : summary.sessions) {
+            out << session.name << ": ";
+            if (!session.error.empty()) {
+                out << "FAILED (" << session.error << ")" << std::endl;
+                continue;
+            }
+            out << session.events << " events, " << session.statistics.tradeCount << " trades, volume "
+                << session.statistics.volume << ", VWAP " << session.statistics.vwap << ", range " << session.low
+                << "-" << session.high << ", " << session.restingOrders << " resting, "
+                << session.seconds * 1000 << " ms" << std::endl;
+        }
+    }
+
+    double rate = summary.wallSeconds > 0 ? summary.events / summary.wallSeconds : 0;
+    out << "===== BACKTEST SUMMARY =====" << std::endl;
+    out << "Sessions: " << summary.sessions.size() << " (" << summary.failed << " failed) on "
+        << summary.threads << " threads, " << summary.steals << " steals" << std::endl;
+    out << "Events: " << summary.events << ", trades: " << summary.trades << ", volume: " << summary.volume << std::endl;
+    out << "VWAP: " << summary.vwap << ", high: " << summary.high << ", low: " << summary.low << std::endl;
+    out << "Wall time: " << summary.wallSeconds << " s (sessions summed: " << summary.sessionSeconds
+        << " s), " << std::setprecision(0) << rate << " events/s" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
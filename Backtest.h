@@ -0,0 +1,74 @@
+#ifndef BACKTEST_H
+#define BACKTEST_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "orderbook.h"
+
+// A session to replay: a recorded event file, or synthetic flow from a seed.
+//
+// Session files hold one event per line; blank lines and '#' comments are
+// skipped:
+//   add <orderid> <buy|sell> <price> <quantity> [FAK|GFD|GTT <expiry>]
+//   cancel <orderid>
+//   modify <orderid> <buy|sell> <price> <quantity>
+//   time <now>
+//   session <close>
+struct SessionSource {
+    std::string path;
+    uint64_t seed = 0;
+
+    static SessionSource FromFile(const std::string& path);
+    static SessionSource FromSeed(uint64_t seed);
+    std::string Name() const;
+};
+
+struct BacktestConfig {
+    size_t threads = 0; // Zero runs one worker per hardware thread
+    size_t eventsPerSeed = 100000;
+    // Every session gets its own book and arena. Sessions are short, so the
+    // arena is faulted in as it is used rather than prefaulted.
+    OrderbookCapacity capacity{65536, 4096, false, false};
+    PriceBand band;
+};
+
+struct SessionResult {
+    std::string name;
+    std::string error; // Empty when the session replayed cleanly
+    uint64_t events = 0;
+    uint64_t ordersAdded = 0;
+    uint64_t cancels = 0;
+    size_t restingOrders = 0;
+    TradeStatistics statistics;
+    Price high = 0;
+    Price low = 0;
+    double seconds = 0;
+};
+
+struct BacktestSummary {
+    std::vector<SessionResult> sessions; // In input order
+    size_t threads = 0;
+    size_t failed = 0;
+    uint64_t events = 0;
+    uint64_t trades = 0;
+    uint64_t volume = 0;
+    Price vwap = 0;
+    Price high = 0;
+    Price low = 0;
+    double sessionSeconds = 0; // Sum of per-session replay times
+    double wallSeconds = 0;
+    uint64_t steals = 0;
+};
+
+// Replays one session on a fresh book
+SessionResult RunSession(const SessionSource& source, const BacktestConfig& config);
+
+// Replays every session in a work-stealing pool and merges the per-session
+// statistics. Results do not depend on the thread count.
+BacktestSummary RunBacktest(const std::vector<SessionSource>& sources, const BacktestConfig& config);
+
+void PrintBacktestReport(std::ostream& out, const BacktestSummary& summary, bool perSession);
+
+#endif // BACKTEST_H
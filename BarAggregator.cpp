@@ -0,0 +1,80 @@
+#include "BarAggregator.h"
+
+#include <algorithm>
+#include <utility>
+
+void BarAggregator::AddInterval(Timestamp interval) {
+    if (interval == 0) {
+        return;
+    }
+    auto existing = std::find_if(series.begin(), series.end(),
+                                 [interval](const Series& entry) { return entry.interval == interval; });
+    if (existing == series.end()) {
+        series.push_back(Series{interval, Bar{}, 0, false});
+    }
+}
+
+void BarAggregator::SetCallback(BarCallback newCallback) { callback = std::move(newCallback); }
+
+void BarAggregator::OnTrade(Timestamp time, Price price, Quantity quantity) {
+    notional += price * quantity;
+    statistics.lastPrice = price;
+    statistics.volume += quantity;
+    statistics.tradeCount += 1;
+    statistics.vwap = notional / statistics.volume;
+
+    for (Series& entry : series) {
+        Bar& bar = entry.bar;
+        if (entry.open && time >= bar.start + entry.interval) {
+            Complete(entry);
+        }
+        if (!entry.open) {
+            bar = Bar{time - time % entry.interval, entry.interval, price, price, price, price, price, 0, 0};
+            entry.notional = 0;
+            entry.open = true;
+        }
+        bar.high = std::max(bar.high, price);
+        bar.low = std::min(bar.low, price);
+        bar.close = price;
+        bar.volume += quantity;
+        bar.tradeCount += 1;
+        entry.notional += price * quantity;
+    }
+}
+
+void BarAggregator::AdvanceTime(Timestamp now) {
+    for (Series& entry : series) {
+        if (entry.open && now >= entry.bar.start + entry.interval) {
+            Complete(entry);
+        }
+    }
+}
+
+const TradeStatistics& BarAggregator::Statistics() const { return statistics; }
+
+bool BarAggregator::CurrentBar(Timestamp interval, Bar& bar) const {
+    for (const Series& entry : series) {
+        if (entry.interval == interval && entry.open) {
+            bar = entry.bar;
+            bar.vwap = entry.notional / bar.volume;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Bar> BarAggregator::TakeCompletedBars() {
+    std::vector<Bar> bars;
+    bars.swap(completed);
+    return bars;
+}
+
+void BarAggregator::Complete(Series& entry) {
+    entry.bar.vwap = entry.notional / entry.bar.volume;
+    entry.open = false;
+    if (callback) {
+        callback(entry.bar);
+    } else {
+        completed.push_back(entry.bar);
+    }
+}
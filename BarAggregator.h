@@ -0,0 +1,66 @@
+#ifndef BAR_AGGREGATOR_H
+#define BAR_AGGREGATOR_H
+
+#include <functional>
+#include <vector>
+#include "Order.h"
+
+// Running statistics over every execution seen by one book
+struct TradeStatistics {
+    Price lastPrice = 0;
+    Price vwap = 0;
+    uint64_t volume = 0;
+    uint64_t tradeCount = 0;
+};
+
+// OHLCV bar covering [start, start + interval)
+struct Bar {
+    Timestamp start;
+    Timestamp interval;
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+    Price vwap;
+    uint64_t volume;
+    uint64_t tradeCount;
+};
+
+// Folds executions into running statistics and OHLCV bars for any number
+// of intervals as they happen, O(1) per trade and interval. A bar completes
+// when a trade or clock advance reaches the end of its interval; intervals
+// without trades produce no bar. Completed bars go to the callback when one
+// is set and are otherwise queued for TakeCompletedBars().
+class BarAggregator {
+public:
+    using BarCallback = std::function<void(const Bar&)>;
+
+    void AddInterval(Timestamp interval);
+    void SetCallback(BarCallback callback);
+
+    void OnTrade(Timestamp time, Price price, Quantity quantity);
+    void AdvanceTime(Timestamp now);
+
+    const TradeStatistics& Statistics() const;
+    // In-progress bar for an interval; false when it has no trades yet
+    bool CurrentBar(Timestamp interval, Bar& bar) const;
+    std::vector<Bar> TakeCompletedBars();
+
+private:
+    struct Series {
+        Timestamp interval;
+        Bar bar;
+        long double notional;
+        bool open;
+    };
+
+    std::vector<Series> series;
+    std::vector<Bar> completed;
+    BarCallback callback;
+    TradeStatistics statistics;
+    long double notional = 0;
+
+    void Complete(Series& entry);
+};
+
+#endif // BAR_AGGREGATOR_H
@@ -0,0 +1,57 @@
+#include "BookSnapshot.h"
+
+#include <cstring>
+#include <thread>
+
+SnapshotPublisher::SnapshotPublisher() : version{0} {
+    for (auto& word : words) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+void SnapshotPublisher::Publish(const BookSnapshot& snapshot) {
+    uint64_t current = version.load(std::memory_order_relaxed);
+    BookSnapshot stamped = snapshot;
+    stamped.sequence = current / 2 + 1;
+
+    uint64_t raw[Words] = {};
+    std::memcpy(raw, &stamped, sizeof(BookSnapshot));
+
+    version.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < Words; ++i) {
+        words[i].store(raw[i], std::memory_order_relaxed);
+    }
+    version.store(current + 2, std::memory_order_release);
+}
+
+bool SnapshotPublisher::TryRead(BookSnapshot& snapshot) const {
+    uint64_t before = version.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+
+    uint64_t raw[Words];
+    for (size_t i = 0; i < Words; ++i) {
+        raw[i] = words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version.load(std::memory_order_relaxed) != before) {
+        return false;
+    }
+
+    std::memcpy(&snapshot, raw, sizeof(BookSnapshot));
+    return true;
+}
+
+BookSnapshot SnapshotPublisher::Read() const {
+    BookSnapshot snapshot;
+    while (!TryRead(snapshot)) {
+        std::this_thread::yield();
+    }
+    return snapshot;
+}
+
+uint64_t SnapshotPublisher::Sequence() const {
+    return version.load(std::memory_order_acquire) / 2;
+}
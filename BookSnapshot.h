@@ -0,0 +1,63 @@
+#ifndef BOOK_SNAPSHOT_H
+#define BOOK_SNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "Order.h"
+
+struct DepthLevel {
+    Price price;
+    uint64_t quantity;
+    uint32_t orderCount;
+};
+
+// Top-of-book view published by the matching thread. bids[0] / asks[0] are
+// the best bid and offer when the matching depth is non-zero.
+struct BookSnapshot {
+    static constexpr size_t Depth = 10;
+
+    uint64_t sequence;  // Publication number, increases with every publish
+    Timestamp time;     // Engine clock at publication
+    std::array<DepthLevel, Depth> bids;
+    std::array<DepthLevel, Depth> asks;
+    uint32_t bidDepth;  // Valid entries in bids
+    uint32_t askDepth;  // Valid entries in asks
+
+    // Book statistics
+    uint64_t orderCount;
+    uint64_t bidLevelCount;
+    uint64_t askLevelCount;
+    uint64_t tradeCount;
+    uint64_t tradedVolume;
+    Price lastTradePrice;
+    Price vwap;
+};
+
+static_assert(std::is_trivially_copyable_v<BookSnapshot>, "snapshots are copied word by word");
+
+// Single-writer seqlock around one BookSnapshot. The writer never waits:
+// it bumps the sequence to odd, stores the payload and bumps it to even.
+// Readers copy the payload and retry if the sequence moved underneath
+// them, so any number of readers can run without touching writer state.
+class SnapshotPublisher {
+public:
+    SnapshotPublisher();
+
+    // Writer side; must only be called from the matching thread
+    void Publish(const BookSnapshot& snapshot);
+
+    // Reader side; safe from any thread
+    BookSnapshot Read() const;
+    bool TryRead(BookSnapshot& snapshot) const;
+    uint64_t Sequence() const;
+
+private:
+    static constexpr size_t Words = (sizeof(BookSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> version;
+    alignas(64) std::array<std::atomic<uint64_t>, Words> words;
+};
+
+#endif // BOOK_SNAPSHOT_H
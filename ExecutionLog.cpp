@@ -0,0 +1,298 @@
+#include "ExecutionLog.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char FileMagic[8] = {'O', 'B', 'E', 'X', 'L', 'O', 'G', '1'};
+constexpr uint32_t FileVersion = 1;
+constexpr uint32_t ChunkMagic = 0x4B484358; // "XCHK"
+constexpr size_t FileHeaderBytes = sizeof(FileMagic) + 2 * sizeof(uint32_t) + sizeof(double);
+constexpr size_t ChunkHeaderBytes = (2 + ExecutionLogWriter::ColumnCount) * sizeof(uint32_t);
+
+size_t Index(ExecutionColumn column) { return static_cast<size_t>(column); }
+
+uint64_t ZigZag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+int64_t UnZigZag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t GetVarint(const uint8_t*& in, const uint8_t* end) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; in != end && shift < 64; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+template <typename T>
+void PutRaw(std::vector<uint8_t>& out, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T GetRaw(const uint8_t* in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    return value;
+}
+
+bool ReadExactly(int fd, void* data, size_t bytes, uint64_t offset) {
+    auto* out = static_cast<uint8_t*>(data);
+    while (bytes > 0) {
+        ssize_t got = pread(fd, out, bytes, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        out += got;
+        bytes -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+}
+
+ExecutionLogWriter::ExecutionLogWriter(const std::string& path, Price tickSize, size_t chunkRows)
+    : fd{-1}, tickSize{static_cast<double>(tickSize)}, chunkRows{chunkRows ? chunkRows : DefaultChunkRows},
+      pendingRows{0}, rows{0}, bytesWritten{0}, failed{false} {
+    if (!(tickSize > 0)) {
+        throw std::invalid_argument("Execution log tick size must be positive");
+    }
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create execution log " + path + ": " + std::strerror(errno));
+    }
+    for (auto& column : columns) {
+        column.reserve(this->chunkRows * 2);
+    }
+    buffer.reserve(BufferBytes);
+    buffer.insert(buffer.end(), FileMagic, FileMagic + sizeof(FileMagic));
+    PutRaw(buffer, FileVersion);
+    PutRaw(buffer, static_cast<uint32_t>(ColumnCount));
+    PutRaw(buffer, this->tickSize);
+}
+
+ExecutionLogWriter::~ExecutionLogWriter() { Close(); }
+
+void ExecutionLogWriter::Append(const Execution& execution) {
+    int64_t ticks = std::llround(static_cast<double>(execution.price / tickSize));
+    PutVarint(columns[Index(ExecutionColumn::MatchId)], ZigZag(static_cast<int64_t>(execution.matchId - previous.matchId)));
+    PutVarint(columns[Index(ExecutionColumn::Time)], ZigZag(static_cast<int64_t>(execution.time - previous.time)));
+    PutVarint(columns[Index(ExecutionColumn::Price)], ZigZag(ticks - previous.ticks));
+    PutVarint(columns[Index(ExecutionColumn::Quantity)], execution.quantity);
+    PutVarint(columns[Index(ExecutionColumn::BidOrderId)], ZigZag(static_cast<int64_t>(execution.bidOrderId - previous.bidOrderId)));
+    PutVarint(columns[Index(ExecutionColumn::AskOrderId)], ZigZag(static_cast<int64_t>(execution.askOrderId - previous.askOrderId)));
+
+    std::vector<uint8_t>& sides = columns[Index(ExecutionColumn::Aggressor)];
+    if (pendingRows % 8 == 0) {
+        sides.push_back(0);
+    }
+    if (execution.aggressor == BuyOrSell::Sell) {
+        sides.back() |= static_cast<uint8_t>(1u << (pendingRows % 8));
+    }
+
+    previous = Previous{execution.matchId, execution.time, ticks, execution.bidOrderId, execution.askOrderId};
+    ++rows;
+    if (++pendingRows == chunkRows) {
+        SealChunk();
+    }
+}
+
+void ExecutionLogWriter::Flush() {
+    SealChunk();
+    WriteBuffer();
+}
+
+void ExecutionLogWriter::Close() {
+    if (fd < 0) {
+        return;
+    }
+    Flush();
+    close(fd);
+    fd = -1;
+}
+
+uint64_t ExecutionLogWriter::Rows() const { return rows; }
+uint64_t ExecutionLogWriter::BytesWritten() const { return bytesWritten; }
+bool ExecutionLogWriter::Failed() const { return failed; }
+
+void ExecutionLogWriter::SealChunk() {
+    if (pendingRows == 0) {
+        return;
+    }
+    PutRaw(buffer, ChunkMagic);
+    PutRaw(buffer, static_cast<uint32_t>(pendingRows));
+    for (const auto& column : columns) {
+        PutRaw(buffer, static_cast<uint32_t>(column.size()));
+    }
+    for (auto& column : columns) {
+        buffer.insert(buffer.end(), column.begin(), column.end());
+        column.clear();
+    }
+    pendingRows = 0;
+    previous = Previous{};
+    if (buffer.size() >= BufferBytes) {
+        WriteBuffer();
+    }
+}
+
+// Write errors are reported once and stop the log; matching never sees them
+void ExecutionLogWriter::WriteBuffer() {
+    size_t offset = 0;
+    while (!failed && fd >= 0 && offset < buffer.size()) {
+        ssize_t written = write(fd, buffer.data() + offset, buffer.size() - offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            std::cerr << "Execution log write failed: " << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    bytesWritten += offset;
+    buffer.clear();
+}
+
+ExecutionLogReader::ExecutionLogReader(const std::string& path) : fd{-1}, tickSize{0}, rows{0} {
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open execution log " + path + ": " + std::strerror(errno));
+    }
+    uint8_t header[FileHeaderBytes];
+    if (!ReadExactly(fd, header, sizeof(header), 0) || std::memcmp(header, FileMagic, sizeof(FileMagic)) != 0 ||
+        GetRaw<uint32_t>(header + 8) != FileVersion || GetRaw<uint32_t>(header + 12) != ExecutionLogWriter::ColumnCount) {
+        close(fd);
+        throw std::runtime_error(path + " is not an execution log");
+    }
+    tickSize = GetRaw<double>(header + 16);
+
+    struct stat status;
+    fstat(fd, &status);
+    uint64_t fileBytes = static_cast<uint64_t>(status.st_size);
+    uint64_t offset = FileHeaderBytes;
+    uint8_t chunkHeader[ChunkHeaderBytes];
+    while (offset + ChunkHeaderBytes <= fileBytes && ReadExactly(fd, chunkHeader, sizeof(chunkHeader), offset)) {
+        if (GetRaw<uint32_t>(chunkHeader) != ChunkMagic) {
+            break;
+        }
+        Chunk chunk{offset + ChunkHeaderBytes, GetRaw<uint32_t>(chunkHeader + 4), {}};
+        uint64_t chunkBytes = 0;
+        for (size_t column = 0; column < ExecutionLogWriter::ColumnCount; ++column) {
+            chunk.bytes[column] = GetRaw<uint32_t>(chunkHeader + 8 + 4 * column);
+            chunkBytes += chunk.bytes[column];
+        }
+        if (chunk.offset + chunkBytes > fileBytes) {
+            break;
+        }
+        chunks.push_back(chunk);
+        rows += chunk.rows;
+        offset = chunk.offset + chunkBytes;
+    }
+}
+
+ExecutionLogReader::~ExecutionLogReader() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+uint64_t ExecutionLogReader::Rows() const { return rows; }
+Price ExecutionLogReader::TickSize() const { return tickSize; }
+
+std::vector<int64_t> ExecutionLogReader::ReadColumn(ExecutionColumn column) const {
+    std::vector<int64_t> values;
+    values.reserve(rows);
+    std::vector<uint8_t> scratch;
+    for (const Chunk& chunk : chunks) {
+        DecodeColumn(chunk, column, scratch, values);
+    }
+    return values;
+}
+
+std::vector<Price> ExecutionLogReader::ReadPrices() const {
+    std::vector<int64_t> ticks = ReadColumn(ExecutionColumn::Price);
+    std::vector<Price> prices;
+    prices.reserve(ticks.size());
+    for (int64_t tick : ticks) {
+        prices.push_back(static_cast<Price>(tick) * static_cast<Price>(tickSize));
+    }
+    return prices;
+}
+
+std::vector<Execution> ExecutionLogReader::ReadAll() const {
+    std::vector<int64_t> matchIds = ReadColumn(ExecutionColumn::MatchId);
+    std::vector<int64_t> times = ReadColumn(ExecutionColumn::Time);
+    std::vector<Price> prices = ReadPrices();
+    std::vector<int64_t> quantities = ReadColumn(ExecutionColumn::Quantity);
+    std::vector<int64_t> aggressors = ReadColumn(ExecutionColumn::Aggressor);
+    std::vector<int64_t> bidOrderIds = ReadColumn(ExecutionColumn::BidOrderId);
+    std::vector<int64_t> askOrderIds = ReadColumn(ExecutionColumn::AskOrderId);
+
+    std::vector<Execution> executions(rows);
+    for (size_t row = 0; row < executions.size(); ++row) {
+        executions[row] = Execution{
+            static_cast<uint64_t>(matchIds[row]), static_cast<Timestamp>(times[row]), prices[row],
+            static_cast<Quantity>(quantities[row]), aggressors[row] ? BuyOrSell::Sell : BuyOrSell::Buy,
+            static_cast<OrderId>(bidOrderIds[row]), static_cast<OrderId>(askOrderIds[row])};
+    }
+    return executions;
+}
+
+void ExecutionLogReader::DecodeColumn(const Chunk& chunk, ExecutionColumn column, std::vector<uint8_t>& scratch,
+                                      std::vector<int64_t>& values) const {
+    size_t index = Index(column);
+    uint64_t offset = chunk.offset;
+    for (size_t before = 0; before < index; ++before) {
+        offset += chunk.bytes[before];
+    }
+    scratch.resize(chunk.bytes[index]);
+    if (!ReadExactly(fd, scratch.data(), scratch.size(), offset)) {
+        throw std::runtime_error("Execution log chunk could not be read");
+    }
+
+    const uint8_t* in = scratch.data();
+    const uint8_t* end = in + scratch.size();
+    if (column == ExecutionColumn::Aggressor) {
+        if (scratch.size() < (chunk.rows + 7) / 8) {
+            throw std::runtime_error("Execution log chunk is corrupt");
+        }
+        for (uint32_t row = 0; row < chunk.rows; ++row) {
+            values.push_back((in[row / 8] >> (row % 8)) & 1);
+        }
+        return;
+    }
+    if (column == ExecutionColumn::Quantity) {
+        for (uint32_t row = 0; row < chunk.rows; ++row) {
+            values.push_back(static_cast<int64_t>(GetVarint(in, end)));
+        }
+        return;
+    }
+    int64_t value = 0;
+    for (uint32_t row = 0; row < chunk.rows; ++row) {
+        value += UnZigZag(GetVarint(in, end));
+        values.push_back(value);
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef EXECUTION_LOG_H
+#define EXECUTION_LOG_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Order.h"
+
+// One fill as recorded for post-trade analysis
+struct Execution {
+    uint64_t matchId;
+    Timestamp time;
+    Price price;
+    Quantity quantity;
+    BuyOrSell aggressor;
+    OrderId bidOrderId;
+    OrderId askOrderId;
+};
+
+enum class ExecutionColumn : uint8_t {
+    MatchId,
+    Time,
+    Price,
+    Quantity,
+    Aggressor,
+    BidOrderId,
+    AskOrderId
+};
+
+// Execution log file layout (native little-endian):
+//   header: "OBEXLOG1", uint32 version, uint32 column count, double tick size
+//   chunks: uint32 "XCHK", uint32 rows, uint32 byte length per column,
+//           then each column's bytes in ExecutionColumn order
+// Prices are stored as integer ticks. Within a chunk, match IDs, times,
+// prices and order IDs are zigzag deltas from the previous row, quantities
+// are plain varints and aggressor sides are packed one bit per row. Every
+// chunk starts from zero, so chunks decode independently.
+class ExecutionLogWriter {
+public:
+    static constexpr size_t ColumnCount = 7;
+    static constexpr size_t DefaultChunkRows = 16384;
+    static constexpr size_t BufferBytes = 1 << 20;
+
+    // Throws std::runtime_error when the file cannot be created. Prices are
+    // rounded to the nearest multiple of tickSize.
+    explicit ExecutionLogWriter(const std::string& path, Price tickSize = 0.0001L,
+                                size_t chunkRows = DefaultChunkRows);
+    ~ExecutionLogWriter();
+    ExecutionLogWriter(const ExecutionLogWriter&) = delete;
+    ExecutionLogWriter& operator=(const ExecutionLogWriter&) = delete;
+
+    void Append(const Execution& execution);
+
+    // Seals the pending chunk and hands everything buffered to the OS
+    void Flush();
+    void Close();
+
+    uint64_t Rows() const;
+    uint64_t BytesWritten() const;
+    bool Failed() const;
+
+private:
+    struct Previous {
+        uint64_t matchId = 0;
+        Timestamp time = 0;
+        int64_t ticks = 0;
+        OrderId bidOrderId = 0;
+        OrderId askOrderId = 0;
+    };
+
+    int fd;
+    double tickSize;
+    size_t chunkRows;
+    size_t pendingRows;
+    uint64_t rows;
+    uint64_t bytesWritten;
+    bool failed;
+    Previous previous;
+    std::array<std::vector<uint8_t>, ColumnCount> columns;
+    std::vector<uint8_t> buffer;
+
+    void SealChunk();
+    void WriteBuffer();
+};
+
+// Reads an execution log. Opening indexes the chunk headers only; each
+// column is read and decoded without touching the bytes of the others.
+class ExecutionLogReader {
+public:
+    // Throws std::runtime_error when the file is missing or not a log. A
+    // truncated trailing chunk (e.g. after a crash) is ignored.
+    explicit ExecutionLogReader(const std::string& path);
+    ~ExecutionLogReader();
+    ExecutionLogReader(const ExecutionLogReader&) = delete;
+    ExecutionLogReader& operator=(const ExecutionLogReader&) = delete;
+
+    uint64_t Rows() const;
+    Price TickSize() const;
+
+    // Raw column values for every row: prices in ticks, aggressor 0 for a
+    // buy and 1 for a sell, everything else as recorded
+    std::vector<int64_t> ReadColumn(ExecutionColumn column) const;
+    std::vector<Price> ReadPrices() const;
+    std::vector<Execution> ReadAll() const;
+
+private:
+    struct Chunk {
+        uint64_t offset; // First column byte
+        uint32_t rows;
+        std::array<uint32_t, ExecutionLogWriter::ColumnCount> bytes;
+    };
+
+    int fd;
+    double tickSize;
+    uint64_t rows;
+    std::vector<Chunk> chunks;
+
+    void DecodeColumn(const Chunk& chunk, ExecutionColumn column, std::vector<uint8_t>& scratch,
+                      std::vector<int64_t>& values) const;
+};
+
+#endif // EXECUTION_LOG_H
@@ -0,0 +1,46 @@
+#include "MatchingPolicy.h"
+
+#include <algorithm>
+
+void AllocateLevel(OrderPointers& level, uint64_t levelQuantity, Quantity incoming, Quantity fifoQuantity,
+                   std::vector<Allocation>& allocations) {
+    // FIFO always takes from the front, so its total is known up front and
+    // the pro-rata pool can be shared out in the same pass
+    uint64_t fifoTotal = std::min<uint64_t>(std::min(fifoQuantity, incoming), levelQuantity);
+    uint64_t pool = incoming - fifoTotal;
+    uint64_t poolBase = levelQuantity - fifoTotal;
+    bool fillsLevel = pool >= poolBase;
+
+    size_t first = allocations.size();
+    uint64_t fifoLeft = fifoTotal;
+    uint64_t allocated = 0;
+    for (auto it = level.begin(); it != level.end(); ++it) {
+        if (fifoLeft == 0 && pool == 0) {
+            break;
+        }
+        if (it->cancelled) {
+            continue;
+        }
+        uint64_t remaining = it->order->GetRemainingQuantity();
+        uint64_t fifoShare = std::min(remaining, fifoLeft);
+        fifoLeft -= fifoShare;
+        remaining -= fifoShare;
+        uint64_t proRataShare = fillsLevel ? remaining : remaining * pool / poolBase;
+        allocations.push_back(Allocation{it, static_cast<Quantity>(fifoShare + proRataShare)});
+        allocated += fifoShare + proRataShare;
+    }
+
+    // Rounding leaves fewer lots than orders, and every order rounded down
+    // still has room for one more
+    uint64_t leftover = std::min<uint64_t>(incoming, levelQuantity) - allocated;
+    for (size_t i = first; i < allocations.size() && leftover > 0; ++i) {
+        if (allocations[i].quantity < allocations[i].order->order->GetRemainingQuantity()) {
+            ++allocations[i].quantity;
+            --leftover;
+        }
+    }
+
+    allocations.erase(std::remove_if(allocations.begin() + first, allocations.end(),
+                                     [](const Allocation& allocation) { return allocation.quantity == 0; }),
+                      allocations.end());
+}
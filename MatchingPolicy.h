@@ -0,0 +1,55 @@
+#ifndef MATCHING_POLICY_H
+#define MATCHING_POLICY_H
+
+#include <vector>
+#include "PriceLadder.h"
+
+// Quantity of an incoming order given to one resting order
+struct Allocation {
+    OrderPointers::iterator order;
+    Quantity quantity;
+};
+
+// Splits an incoming quantity across one resting level in a single pass.
+// The first fifoQuantity goes to orders in time priority; the rest is
+// shared pro-rata by each order's remaining quantity, rounded down, with
+// the leftover lots handed out one each in time priority. Allocations are
+// appended in time priority. Cancelled orders (tombstones) are skipped and
+// levelQuantity counts live orders only.
+void AllocateLevel(OrderPointers& level, uint64_t levelQuantity, Quantity incoming, Quantity fifoQuantity,
+                   std::vector<Allocation>& allocations);
+
+// Matching policies decide how an aggressive order is allocated across the
+// resting orders of the best opposite level. Each provides
+//   static void Allocate(OrderPointers& level, uint64_t levelQuantity,
+//                        Quantity incoming, std::vector<Allocation>& allocations);
+
+// Strict price-time priority
+struct FifoMatching {
+    static void Allocate(OrderPointers& level, uint64_t levelQuantity, Quantity incoming,
+                         std::vector<Allocation>& allocations) {
+        AllocateLevel(level, levelQuantity, incoming, incoming, allocations);
+    }
+};
+
+// Pure pro-rata by resting size
+struct ProRataMatching {
+    static void Allocate(OrderPointers& level, uint64_t levelQuantity, Quantity incoming,
+                         std::vector<Allocation>& allocations) {
+        AllocateLevel(level, levelQuantity, incoming, 0, allocations);
+    }
+};
+
+// FifoPercent of the incoming quantity by time priority, the rest pro-rata
+template <unsigned FifoPercent = 40>
+struct FifoProRataMatching {
+    static_assert(FifoPercent <= 100, "FIFO share is a percentage");
+
+    static void Allocate(OrderPointers& level, uint64_t levelQuantity, Quantity incoming,
+                         std::vector<Allocation>& allocations) {
+        Quantity fifoQuantity = static_cast<Quantity>(static_cast<uint64_t>(incoming) * FifoPercent / 100);
+        AllocateLevel(level, levelQuantity, incoming, fifoQuantity, allocations);
+    }
+};
+
+#endif // MATCHING_POLICY_H
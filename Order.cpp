@@ -1,7 +1,7 @@
 #include "Order.h"
 
-Order::Order(OrderType ordertype, OrderId orderid, BuyOrSell buyorsell, Price price, Quantity quantity)
-    : ordertype{ordertype}, orderid{orderid}, buyorsell{buyorsell}, price{price}, initialQuantity{quantity}, remainingQuantity{quantity} {}
+Order::Order(OrderType ordertype, OrderId orderid, BuyOrSell buyorsell, Price price, Quantity quantity, Timestamp expiry)
+    : ordertype{ordertype}, orderid{orderid}, buyorsell{buyorsell}, price{price}, initialQuantity{quantity}, remainingQuantity{quantity}, expiry{expiry} {}
 
 OrderId Order::GetOrderId() const { return orderid; }
 BuyOrSell Order::GetBuyOrSell() const { return buyorsell; }
@@ -10,6 +10,7 @@ OrderType Order::GetOrderType() const { return ordertype; }
 Quantity Order::GetInitalQuantity() const { return initialQuantity; }
 Quantity Order::GetRemainingQuantity() const { return remainingQuantity; }
 Quantity Order::GetFilledQuantity() const { return GetInitalQuantity() - GetRemainingQuantity(); }
+Timestamp Order::GetExpiry() const { return expiry; }
 bool Order::IsFilled() const { return GetRemainingQuantity() == 0; }
 
 void Order::Fill(Quantity quantity) {
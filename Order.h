@@ -7,7 +7,9 @@
 
 enum class OrderType {
     GoodTillCancel,
-    FillAndKill
+    FillAndKill,
+    GoodTillTime,
+    GoodForDay
 };
 
 enum class BuyOrSell {
@@ -18,10 +20,11 @@ enum class BuyOrSell {
 using Price = long double;
 using Quantity = uint32_t;
 using OrderId = uint64_t;
+using Timestamp = uint64_t; // Engine clock, milliseconds by convention
 
 class Order {
 public:
-    Order(OrderType ordertype, OrderId orderid, BuyOrSell buyorsell, Price price, Quantity quantity);
+    Order(OrderType ordertype, OrderId orderid, BuyOrSell buyorsell, Price price, Quantity quantity, Timestamp expiry = 0);
 
     OrderId GetOrderId() const;
     BuyOrSell GetBuyOrSell() const;
@@ -30,6 +33,7 @@ public:
     Quantity GetInitalQuantity() const;
     Quantity GetRemainingQuantity() const;
     Quantity GetFilledQuantity() const;
+    Timestamp GetExpiry() const;
     bool IsFilled() const;
     void Fill(Quantity quantity);
 
@@ -43,6 +47,7 @@ private:
     Price price;
     Quantity remainingQuantity;
     Quantity initialQuantity;
+    Timestamp expiry;
 };
 
 using OrderPointer = std::shared_ptr<Order>;
@@ -10,6 +10,6 @@ Quantity OrderModify::GetQuantity() const { return quantity; }
 
 void OrderModify::SetOrderId(OrderId newOrderId) { orderid = newOrderId; }
 
-OrderPointer OrderModify::ToOrderPointer(OrderType type) const {
-    return std::make_shared<Order>(type, GetOrderId(), GetBuyOrSell(), GetPrice(), GetQuantity());
+OrderPointer OrderModify::ToOrderPointer(OrderType type, Timestamp expiry) const {
+    return std::make_shared<Order>(type, GetOrderId(), GetBuyOrSell(), GetPrice(), GetQuantity(), expiry);
 } 
\ No newline at end of file
@@ -11,7 +11,7 @@ public:
     Price GetPrice() const;
     BuyOrSell GetBuyOrSell() const;
     Quantity GetQuantity() const;
-    OrderPointer ToOrderPointer(OrderType type) const;
+    OrderPointer ToOrderPointer(OrderType type, Timestamp expiry = 0) const;
 
     void SetOrderId(OrderId newOrderId);
     
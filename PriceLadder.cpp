@@ -0,0 +1,139 @@
+#include "PriceLadder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr uint64_t AllBits = ~uint64_t{0};
+
+size_t LowBit(uint64_t bits) { return static_cast<size_t>(__builtin_ctzll(bits)); }
+size_t HighBit(uint64_t bits) { return static_cast<size_t>(63 - __builtin_clzll(bits)); }
+
+// Bits strictly above / below a position within one word
+uint64_t Above(uint64_t bits, size_t position) { return position >= 63 ? 0 : bits & (AllBits << (position + 1)); }
+uint64_t Below(uint64_t bits, size_t position) { return position == 0 ? 0 : bits & (AllBits >> (64 - position)); }
+}
+
+void PriceLadder::Configure(const PriceBand& newBand, const OrderPointers::allocator_type& allocator) {
+    band = newBand;
+    band.levelCount = band.tickSize > 0 ? std::min(band.levelCount, MaxLevels) : 0;
+    levels.clear();
+    levels.resize(band.levelCount, PriceLevel{0, OrderPointers(allocator)});
+    leaves.assign((band.levelCount + 63) / 64, 0);
+    summary.assign((leaves.size() + 63) / 64, 0);
+    root = 0;
+    occupiedCount = 0;
+}
+
+const PriceBand& PriceLadder::Band() const { return band; }
+bool PriceLadder::Enabled() const { return band.levelCount != 0; }
+
+size_t PriceLadder::IndexOf(Price price) const {
+    if (!Enabled()) {
+        return NoLevel;
+    }
+    Price offset = (price - band.basePrice) / band.tickSize;
+    Price tick = std::round(offset);
+    if (tick < 0 || tick >= static_cast<Price>(band.levelCount) || std::fabs(offset - tick) > 1e-6L) {
+        return NoLevel;
+    }
+    return static_cast<size_t>(tick);
+}
+
+bool PriceLadder::Occupied(size_t index) const { return (leaves[index >> 6] >> (index & 63)) & 1; }
+PriceLevel& PriceLadder::Level(size_t index) { return levels[index]; }
+const PriceLevel& PriceLadder::Level(size_t index) const { return levels[index]; }
+
+PriceLevel& PriceLadder::Occupy(size_t index, Price price) {
+    size_t leaf = index >> 6;
+    leaves[leaf] |= uint64_t{1} << (index & 63);
+    summary[leaf >> 6] |= uint64_t{1} << (leaf & 63);
+    root |= uint64_t{1} << (leaf >> 6);
+    ++occupiedCount;
+    levels[index].price = price;
+    levels[index].quantity = 0;
+    levels[index].tombstones = 0;
+    return levels[index];
+}
+
+void PriceLadder::Release(size_t index) {
+    levels[index].orders.clear();
+    levels[index].quantity = 0;
+    levels[index].tombstones = 0;
+    --occupiedCount;
+    size_t leaf = index >> 6;
+    leaves[leaf] &= ~(uint64_t{1} << (index & 63));
+    if (leaves[leaf] == 0) {
+        summary[leaf >> 6] &= ~(uint64_t{1} << (leaf & 63));
+        if (summary[leaf >> 6] == 0) {
+            root &= ~(uint64_t{1} << (leaf >> 6));
+        }
+    }
+}
+
+bool PriceLadder::Empty() const { return root == 0; }
+size_t PriceLadder::Size() const { return occupiedCount; }
+
+size_t PriceLadder::Lowest() const {
+    if (root == 0) {
+        return NoLevel;
+    }
+    size_t word = LowBit(root);
+    size_t leaf = (word << 6) | LowBit(summary[word]);
+    return (leaf << 6) | LowBit(leaves[leaf]);
+}
+
+size_t PriceLadder::Highest() const {
+    if (root == 0) {
+        return NoLevel;
+    }
+    size_t word = HighBit(root);
+    size_t leaf = (word << 6) | HighBit(summary[word]);
+    return (leaf << 6) | HighBit(leaves[leaf]);
+}
+
+size_t PriceLadder::NextAbove(size_t index) const {
+    size_t leaf = index >> 6;
+    if (uint64_t bits = Above(leaves[leaf], index & 63)) {
+        return (leaf << 6) | LowBit(bits);
+    }
+    size_t word = leaf >> 6;
+    if (uint64_t bits = Above(summary[word], leaf & 63)) {
+        leaf = (word << 6) | LowBit(bits);
+        return (leaf << 6) | LowBit(leaves[leaf]);
+    }
+    if (uint64_t bits = Above(root, word)) {
+        word = LowBit(bits);
+        leaf = (word << 6) | LowBit(summary[word]);
+        return (leaf << 6) | LowBit(leaves[leaf]);
+    }
+    return NoLevel;
+}
+
+size_t PriceLadder::NextBelow(size_t index) const {
+    size_t leaf = index >> 6;
+    if (uint64_t bits = Below(leaves[leaf], index & 63)) {
+        return (leaf << 6) | HighBit(bits);
+    }
+    size_t word = leaf >> 6;
+    if (uint64_t bits = Below(summary[word], leaf & 63)) {
+        leaf = (word << 6) | HighBit(bits);
+        return (leaf << 6) | HighBit(leaves[leaf]);
+    }
+    if (uint64_t bits = Below(root, word)) {
+        word = HighBit(bits);
+        leaf = (word << 6) | HighBit(summary[word]);
+        return (leaf << 6) | HighBit(leaves[leaf]);
+    }
+    return NoLevel;
+}
+
+void PriceLadder::Clear() {
+    for (size_t index = Lowest(); index != NoLevel; index = NextAbove(index)) {
+        levels[index].orders.clear();
+    }
+    std::fill(leaves.begin(), leaves.end(), 0);
+    std::fill(summary.begin(), summary.end(), 0);
+    root = 0;
+    occupiedCount = 0;
+}
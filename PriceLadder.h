@@ -0,0 +1,201 @@
+#ifndef PRICE_LADDER_H
+#define PRICE_LADDER_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Order.h"
+#include "Arena.h"
+
+// An order linked into its level. A lazy cancel marks the entry, not the
+// caller's Order, so the same Order can later be added again.
+struct RestingOrder {
+    OrderPointer order;
+    bool cancelled = false;
+};
+
+using OrderPointers = std::list<RestingOrder, ArenaAllocator<RestingOrder>>;
+
+struct PriceLevel {
+    Price price;
+    OrderPointers orders;
+    uint64_t quantity = 0;   // Remaining quantity across the level's live orders
+    uint32_t tombstones = 0; // Cancelled orders still linked into the list
+};
+
+// Bounded price band for the dense ladder; levelCount == 0 disables it
+struct PriceBand {
+    Price tickSize = 0;
+    Price basePrice = 0;
+    size_t levelCount = 0;
+};
+
+// Contiguous array of price levels indexed by tick offset from the band's
+// base price. Occupancy is kept in a three-level bitmap (levels, leaf words,
+// summary words) so the lowest/highest/next occupied level is found with at
+// most three count-leading/trailing-zero steps instead of a word scan.
+class PriceLadder {
+public:
+    static constexpr size_t MaxLevels = 64 * 64 * 64;
+    static constexpr size_t NoLevel = SIZE_MAX;
+
+    // Discards every level; the band is capped at MaxLevels. Order lists
+    // allocate their nodes through the given allocator.
+    void Configure(const PriceBand& band, const OrderPointers::allocator_type& allocator = OrderPointers::allocator_type{});
+    const PriceBand& Band() const;
+    bool Enabled() const;
+
+    // NoLevel when the price is outside the band or not on a tick
+    size_t IndexOf(Price price) const;
+
+    bool Occupied(size_t index) const;
+    PriceLevel& Level(size_t index);
+    const PriceLevel& Level(size_t index) const;
+    PriceLevel& Occupy(size_t index, Price price);
+    void Release(size_t index);
+
+    bool Empty() const;
+    size_t Size() const;
+    size_t Lowest() const;
+    size_t Highest() const;
+    size_t NextAbove(size_t index) const;
+    size_t NextBelow(size_t index) const;
+    void Clear();
+
+private:
+    PriceBand band;
+    std::vector<PriceLevel> levels;
+    std::vector<uint64_t> leaves;  // bit per level
+    std::vector<uint64_t> summary; // bit per non-empty leaf word
+    uint64_t root = 0;             // bit per non-empty summary word
+    size_t occupiedCount = 0;
+};
+
+// One side of the book. Levels inside the configured band live in the dense
+// ladder; anything outside it (or every level, when no band is configured)
+// falls back to an ordered map. Compare gives the side's priority order.
+template <typename Compare>
+class PriceLevels {
+public:
+    static constexpr bool Descending = std::is_same_v<Compare, std::greater<Price>>;
+    using Allocator = OrderPointers::allocator_type;
+
+    explicit PriceLevels(const Allocator& allocator = Allocator{})
+        : allocator{allocator}, overflow{Compare(), MapAllocator(allocator)} {}
+
+    void Configure(const PriceBand& band) {
+        Clear();
+        ladder.Configure(band, allocator);
+    }
+
+    bool Empty() const { return ladder.Empty() && overflow.empty(); }
+    size_t Size() const { return ladder.Size() + overflow.size(); }
+
+    // Highest-priority level; the side must not be empty
+    const PriceLevel& Best() const {
+        if (ladder.Empty()) {
+            return overflow.begin()->second;
+        }
+        const PriceLevel& inBand = ladder.Level(Descending ? ladder.Highest() : ladder.Lowest());
+        if (!overflow.empty() && Compare()(overflow.begin()->first, inBand.price)) {
+            return overflow.begin()->second;
+        }
+        return inBand;
+    }
+
+    PriceLevel& Best() { return const_cast<PriceLevel&>(std::as_const(*this).Best()); }
+
+    PriceLevel* Find(Price price) {
+        size_t index = ladder.IndexOf(price);
+        if (index != PriceLadder::NoLevel) {
+            return ladder.Occupied(index) ? &ladder.Level(index) : nullptr;
+        }
+        auto it = overflow.find(price);
+        return it != overflow.end() ? &it->second : nullptr;
+    }
+
+    PriceLevel& GetOrCreate(Price price) {
+        size_t index = ladder.IndexOf(price);
+        if (index != PriceLadder::NoLevel) {
+            return ladder.Occupied(index) ? ladder.Level(index) : ladder.Occupy(index, price);
+        }
+        return overflow.try_emplace(price, PriceLevel{price, OrderPointers(allocator)}).first->second;
+    }
+
+    void Erase(Price price) {
+        size_t index = ladder.IndexOf(price);
+        if (index != PriceLadder::NoLevel) {
+            ladder.Release(index);
+        } else {
+            overflow.erase(price);
+        }
+    }
+
+    // Moves the band to a new base price, re-homing every level between the
+    // ladder and the overflow map. Order lists are moved, so iterators held
+    // into them stay valid.
+    void Recenter(Price basePrice) {
+        std::vector<PriceLevel> moved;
+        for (size_t index = ladder.Lowest(); index != PriceLadder::NoLevel; index = ladder.NextAbove(index)) {
+            moved.push_back(std::move(ladder.Level(index)));
+        }
+        for (auto& [price, level] : overflow) {
+            moved.push_back(std::move(level));
+        }
+        overflow.clear();
+
+        PriceBand band = ladder.Band();
+        band.basePrice = basePrice;
+        ladder.Configure(band, allocator);
+        for (auto& level : moved) {
+            PriceLevel& target = GetOrCreate(level.price);
+            target.orders = std::move(level.orders);
+            target.quantity = level.quantity;
+            target.tombstones = level.tombstones;
+        }
+    }
+
+    // Visits levels best-first, merging ladder and overflow, until the
+    // visitor returns false
+    template <typename Visitor>
+    void ForEachLevel(Visitor&& visit) {
+        std::as_const(*this).ForEachLevel([&visit](const PriceLevel& level) { return visit(const_cast<PriceLevel&>(level)); });
+    }
+
+    template <typename Visitor>
+    void ForEachLevel(Visitor&& visit) const {
+        auto it = overflow.begin();
+        size_t index = Descending ? ladder.Highest() : ladder.Lowest();
+        while (it != overflow.end() || index != PriceLadder::NoLevel) {
+            bool fromOverflow = index == PriceLadder::NoLevel ||
+                (it != overflow.end() && Compare()(it->first, ladder.Level(index).price));
+            const PriceLevel& level = fromOverflow ? it->second : ladder.Level(index);
+            if (fromOverflow) {
+                ++it;
+            } else {
+                index = Descending ? ladder.NextBelow(index) : ladder.NextAbove(index);
+            }
+            if (!visit(level)) {
+                return;
+            }
+        }
+    }
+
+    void Clear() {
+        ladder.Clear();
+        overflow.clear();
+    }
+
+private:
+    using MapAllocator = ArenaAllocator<std::pair<const Price, PriceLevel>>;
+
+    Allocator allocator;
+    PriceLadder ladder;
+    std::map<Price, PriceLevel, Compare, MapAllocator> overflow;
+};
+
+#endif // PRICE_LADDER_H
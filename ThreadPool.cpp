@@ -0,0 +1,106 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+// Identifies the pool and deque of the worker running on this thread
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : queued{0}, stopping{false}, pending{0}, nextWorker{0}, steals{0} {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t index = 0; index < threadCount; ++index) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t index = 0; index < threadCount; ++index) {
+        threads.emplace_back([this, index] { Run(index); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(Task task) {
+    size_t index = currentPool == this ? currentWorker : nextWorker++ % workers.size();
+    ++pending;
+    {
+        std::lock_guard<std::mutex> sleepLock(sleepMutex);
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return pending == 0; });
+}
+
+size_t ThreadPool::Size() const { return workers.size(); }
+uint64_t ThreadPool::Steals() const { return steals; }
+
+bool ThreadPool::TryPop(size_t index, Task& task) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t index, Task& task) {
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            ++steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Submit counts a task in queued as it enters a deque, under both locks, so
+// queued never drops below the number of tasks a worker can still find
+void ThreadPool::Run(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        Task task;
+        if (TryPop(index, task) || TrySteal(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                --queued;
+            }
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
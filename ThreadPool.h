@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers, each with its own task deque. A worker runs its
+// newest task first and, when its deque is empty, steals the oldest task
+// from another worker. Tasks submitted from inside a task go to the
+// submitting worker's deque; others are spread round-robin. Each deque has
+// its own lock; one shared lock only counts queued tasks and parks idle
+// workers, which suits coarse tasks such as whole sessions.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Zero threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Tasks must not throw
+    void Submit(Task task);
+
+    // Blocks until every submitted task, including ones submitted by other
+    // tasks, has finished. Must not be called from inside a task.
+    void Wait();
+
+    size_t Size() const;
+    uint64_t Steals() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    size_t queued; // Tasks waiting in any deque; guarded by sleepMutex
+    bool stopping; // Guarded by sleepMutex
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextWorker;
+    std::atomic<uint64_t> steals;
+
+    bool TryPop(size_t index, Task& task);
+    bool TrySteal(size_t index, Task& task);
+    void Run(size_t index);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,203 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr Timestamp NoEvent = std::numeric_limits<Timestamp>::max();
+}
+
+TimerWheel::TimerWheel(Timestamp now)
+    : freeList{InvalidHandle}, now{now}, overflowMin{NoEvent}, size{0}, steps{0} {
+    heads.fill(InvalidHandle);
+    occupied.fill(0);
+}
+
+TimerWheel::Handle TimerWheel::Schedule(OrderId orderid, Timestamp expiry) {
+    Handle handle = Allocate();
+    nodes[handle] = Node{orderid, std::max(expiry, now + 1), InvalidHandle, InvalidHandle, 0};
+    Place(handle);
+    ++size;
+    return handle;
+}
+
+void TimerWheel::Cancel(Handle handle) {
+    if (handle == InvalidHandle) {
+        return;
+    }
+    Unlink(handle);
+    Release(handle);
+    --size;
+}
+
+void TimerWheel::Advance(Timestamp target, std::vector<OrderId>& expired) {
+    while (now < target) {
+        Timestamp next = NextEventTime();
+        if (next > target) {
+            now = target;
+            return;
+        }
+        now = next;
+        ++steps;
+        Process(expired);
+    }
+}
+
+// Threads the new nodes onto the free list so the lowest handles go first
+void TimerWheel::Reserve(size_t timers) {
+    size_t first = nodes.size();
+    if (timers <= first) {
+        return;
+    }
+    nodes.resize(timers);
+    for (size_t handle = timers; handle-- > first;) {
+        Release(static_cast<Handle>(handle));
+    }
+}
+
+void TimerWheel::Clear() {
+    freeList = InvalidHandle;
+    for (size_t handle = nodes.size(); handle-- > 0;) {
+        Release(static_cast<Handle>(handle));
+    }
+    heads.fill(InvalidHandle);
+    occupied.fill(0);
+    overflowMin = NoEvent;
+    size = 0;
+}
+
+void TimerWheel::Reset(Timestamp time) {
+    Clear();
+    now = time;
+}
+
+Timestamp TimerWheel::Now() const { return now; }
+size_t TimerWheel::Size() const { return size; }
+uint64_t TimerWheel::Steps() const { return steps; }
+
+TimerWheel::Handle TimerWheel::Allocate() {
+    if (freeList != InvalidHandle) {
+        Handle handle = freeList;
+        freeList = nodes[handle].next;
+        return handle;
+    }
+    nodes.emplace_back();
+    return static_cast<Handle>(nodes.size() - 1);
+}
+
+void TimerWheel::Release(Handle handle) {
+    nodes[handle].next = freeList;
+    freeList = handle;
+}
+
+void TimerWheel::Link(Handle handle, uint16_t slot) {
+    Node& node = nodes[handle];
+    node.slot = slot;
+    node.prev = InvalidHandle;
+    node.next = heads[slot];
+    if (node.next != InvalidHandle) {
+        nodes[node.next].prev = handle;
+    }
+    heads[slot] = handle;
+    if (slot != OverflowSlot) {
+        occupied[slot / SlotCount] |= uint64_t{1} << (slot % SlotCount);
+    }
+}
+
+void TimerWheel::Unlink(Handle handle) {
+    const Node& node = nodes[handle];
+    if (node.prev != InvalidHandle) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.slot] = node.next;
+    }
+    if (node.next != InvalidHandle) {
+        nodes[node.next].prev = node.prev;
+    }
+    if (heads[node.slot] == InvalidHandle) {
+        if (node.slot != OverflowSlot) {
+            occupied[node.slot / SlotCount] &= ~(uint64_t{1} << (node.slot % SlotCount));
+        } else {
+            // A stale minimum would later pin the clock to single steps
+            overflowMin = NoEvent;
+        }
+    }
+}
+
+// The level is the highest 6-bit digit in which expiry and now differ; the
+// expiry is always later, so its digit there is ahead of the clock's.
+void TimerWheel::Place(Handle handle) {
+    Timestamp expiry = nodes[handle].expiry;
+    Timestamp diff = expiry ^ now;
+    if (diff >> WheelBits) {
+        overflowMin = std::min(overflowMin, expiry);
+        Link(handle, OverflowSlot);
+        return;
+    }
+    unsigned level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / SlotBits;
+    unsigned digit = (expiry >> (level * SlotBits)) & (SlotCount - 1);
+    Link(handle, static_cast<uint16_t>(level * SlotCount + digit));
+}
+
+TimerWheel::Handle TimerWheel::Detach(uint16_t slot) {
+    Handle list = heads[slot];
+    heads[slot] = InvalidHandle;
+    if (slot != OverflowSlot) {
+        occupied[slot / SlotCount] &= ~(uint64_t{1} << (slot % SlotCount));
+    } else {
+        overflowMin = NoEvent;
+    }
+    return list;
+}
+
+// Slots at or behind the clock's digit are always empty, so the first level
+// with a pending slot ahead of the clock holds the next event. Overflow
+// timers are only requeued on a block boundary, so that is the next event
+// for them even if the minimum already lies in the current block.
+Timestamp TimerWheel::NextEventTime() const {
+    for (unsigned level = 0; level < LevelCount; ++level) {
+        unsigned shift = level * SlotBits;
+        unsigned digit = (now >> shift) & (SlotCount - 1);
+        uint64_t pending = digit == SlotCount - 1 ? 0 : occupied[level] & (~uint64_t{0} << (digit + 1));
+        if (pending) {
+            Timestamp epoch = (now >> (shift + SlotBits)) << (shift + SlotBits);
+            return epoch | (static_cast<Timestamp>(__builtin_ctzll(pending)) << shift);
+        }
+    }
+    if (heads[OverflowSlot] != InvalidHandle) {
+        Timestamp block = (overflowMin >> WheelBits) << WheelBits;
+        return block > now ? block : ((now >> WheelBits) + 1) << WheelBits;
+    }
+    return NoEvent;
+}
+
+void TimerWheel::Process(std::vector<OrderId>& expired) {
+    if ((now & ((Timestamp{1} << WheelBits) - 1)) == 0 && heads[OverflowSlot] != InvalidHandle) {
+        Requeue(Detach(OverflowSlot), expired);
+    }
+    for (unsigned level = LevelCount - 1; level > 0; --level) {
+        if ((now & ((Timestamp{1} << (level * SlotBits)) - 1)) != 0) {
+            continue;
+        }
+        unsigned digit = (now >> (level * SlotBits)) & (SlotCount - 1);
+        uint16_t slot = static_cast<uint16_t>(level * SlotCount + digit);
+        if (heads[slot] != InvalidHandle) {
+            Requeue(Detach(slot), expired);
+        }
+    }
+    Requeue(Detach(static_cast<uint16_t>(now & (SlotCount - 1))), expired);
+}
+
+void TimerWheel::Requeue(Handle list, std::vector<OrderId>& expired) {
+    while (list != InvalidHandle) {
+        Handle handle = list;
+        list = nodes[handle].next;
+        if (nodes[handle].expiry <= now) {
+            expired.push_back(nodes[handle].orderid);
+            Release(handle);
+            --size;
+        } else {
+            Place(handle);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Order.h"
+
+// Hierarchical timing wheel keyed by absolute expiry timestamps.
+// Every level has 64 slots indexed by one 6-bit digit of the expiry time.
+// A timer sits in the level of the highest digit where its expiry differs
+// from the current time and is cascaded down when the clock reaches that
+// slot. Timers further out than the top level wait in an overflow list.
+// Schedule and Cancel are O(1); Advance skips empty slots via per-level
+// occupancy bitmaps, so jumping the clock costs O(levels + timers moved).
+class TimerWheel {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = UINT32_MAX;
+
+    explicit TimerWheel(Timestamp now = 0);
+
+    // Expiry must be later than Now(); earlier expiries fire on the next tick
+    Handle Schedule(OrderId orderid, Timestamp expiry);
+    void Cancel(Handle handle);
+
+    // Moves the clock forward and appends every order due at or before `now`
+    void Advance(Timestamp now, std::vector<OrderId>& expired);
+
+    // Builds a pool of this many timer nodes up front, so scheduling never
+    // grows or first touches the node array until the pool runs out
+    void Reserve(size_t timers);
+    // Discards every timer; pooled nodes are kept for reuse
+    void Clear();
+    // Clear, restarting the clock at `now`
+    void Reset(Timestamp now);
+    Timestamp Now() const;
+    size_t Size() const;
+    // Clock positions Advance has stopped at; each costs one slot scan
+    uint64_t Steps() const;
+
+private:
+    static constexpr unsigned SlotBits = 6;
+    static constexpr unsigned SlotCount = 1u << SlotBits;
+    static constexpr unsigned LevelCount = 5;
+    static constexpr unsigned WheelBits = SlotBits * LevelCount;
+    static constexpr uint16_t OverflowSlot = LevelCount * SlotCount;
+
+    struct Node {
+        OrderId orderid;
+        Timestamp expiry;
+        Handle prev;
+        Handle next;
+        uint16_t slot; // level * SlotCount + digit, or OverflowSlot
+    };
+
+    std::vector<Node> nodes;
+    Handle freeList;
+    std::array<Handle, LevelCount * SlotCount + 1> heads;
+    std::array<uint64_t, LevelCount> occupied;
+    Timestamp now;
+    Timestamp overflowMin;
+    size_t size;
+    uint64_t steps;
+
+    Handle Allocate();
+    void Release(Handle handle);
+    void Link(Handle handle, uint16_t slot);
+    void Unlink(Handle handle);
+    void Place(Handle handle);
+    Handle Detach(uint16_t slot);
+    Timestamp NextEventTime() const;
+    void Process(std::vector<OrderId>& expired);
+    void Requeue(Handle list, std::vector<OrderId>& expired);
+};
+
+#endif // TIMER_WHEEL_H
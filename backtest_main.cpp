@@ -0,0 +1,65 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Backtest.h"
+
+using namespace std;
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " [options] [session files...]" << endl;
+    cout << "  -j, --threads <n>   Worker threads (default: one per core)" << endl;
+    cout << "  --seeds <n>         Add generated sessions for seeds 1..n" << endl;
+    cout << "  --seed <s>          Add a generated session for seed s" << endl;
+    cout << "  --events <n>        Events per generated session (default 100000)" << endl;
+    cout << "  --verbose           Report every session" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BacktestConfig config;
+        vector<SessionSource> sources;
+        bool verbose = false;
+
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if ((arg == "-j" || arg == "--threads") && hasValue) {
+                config.threads = stoul(argv[++i]);
+            } else if (arg == "--seeds" && hasValue) {
+                uint64_t count = stoull(argv[++i]);
+                for (uint64_t seed = 1; seed <= count; ++seed) {
+                    sources.push_back(SessionSource::FromSeed(seed));
+                }
+            } else if (arg == "--seed" && hasValue) {
+                sources.push_back(SessionSource::FromSeed(stoull(argv[++i])));
+            } else if (arg == "--events" && hasValue) {
+                config.eventsPerSeed = stoull(argv[++i]);
+            } else if (arg == "--verbose") {
+                verbose = true;
+            } else if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (arg[0] == '-') {
+                cout << "Unknown or incomplete option: " << arg << endl;
+                printUsage(argv[0]);
+                return 1;
+            } else {
+                sources.push_back(SessionSource::FromFile(arg));
+            }
+        }
+
+        if (sources.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        BacktestSummary summary = RunBacktest(sources, config);
+        PrintBacktestReport(cout, summary, verbose);
+        return summary.failed == 0 ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+}
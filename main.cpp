@@ -8,7 +8,8 @@
 #include "Order.h"
 #include "OrderModify.h"
 #include "Trade.h"
-#include "Orderbook.h"
+#include "orderbook.h"
+#include "ExecutionLog.h"
 
 using namespace std;
 
@@ -36,6 +37,16 @@ void printTrade(const Trade& trade) {
          << ", Quantity: " << askTrade.quantity << endl;
 }
 
+// Helper to name an order type
+string orderTypeName(OrderType orderType) {
+    switch (orderType) {
+        case OrderType::FillAndKill: return "FAK";
+        case OrderType::GoodTillTime: return "GTT";
+        case OrderType::GoodForDay: return "GFD";
+        default: return "GTC";
+    }
+}
+
 // Process a simple CLI command
 bool processCommand(const string& cmd, Orderbook& orderbook) {
     static OrderId nextOrderId = 1;
@@ -48,10 +59,13 @@ bool processCommand(const string& cmd, Orderbook& orderbook) {
     } 
     else if (action == "help") {
         cout << "Available commands:" << endl;
-        cout << "  buy <price> <quantity> [FAK]     - Place a buy order" << endl;
-        cout << "  sell <price> <quantity> [FAK]    - Place a sell order" << endl;
+        cout << "  buy <price> <quantity> [FAK|GFD|GTT <expiry>]  - Place a buy order" << endl;
+        cout << "  sell <price> <quantity> [FAK|GFD|GTT <expiry>] - Place a sell order" << endl;
         cout << "  cancel <orderid>                 - Cancel an order" << endl;
         cout << "  modify <orderid> <price> <quantity> - Modify an order" << endl;
+        cout << "  session <close>                 - Set the GoodForDay expiry time" << endl;
+        cout << "  time <now>                      - Advance the clock, expiring due orders" << endl;
+        cout << "  stats                           - Show last price, VWAP and volume" << endl;
         cout << "  clear                           - Clear all orders" << endl;
         cout << "  quit/exit                       - Exit the program" << endl;
     } 
@@ -67,10 +81,19 @@ bool processCommand(const string& cmd, Orderbook& orderbook) {
             return true;
         }
         
-        // Check for optional FAK parameter
+        // Check for optional order type parameter
+        Timestamp expiry = 0;
         ss >> orderTypeStr;
         if (orderTypeStr == "FAK") {
             orderType = OrderType::FillAndKill;
+        } else if (orderTypeStr == "GFD") {
+            orderType = OrderType::GoodForDay;
+        } else if (orderTypeStr == "GTT") {
+            orderType = OrderType::GoodTillTime;
+            if (!(ss >> expiry)) {
+                cout << "Error: GTT orders need an expiry time" << endl;
+                return true;
+            }
         }
         
         // Create and add the order
@@ -79,9 +102,9 @@ bool processCommand(const string& cmd, Orderbook& orderbook) {
              << " order ID: " << orderId 
              << ", Price: " << price 
              << ", Quantity: " << quantity 
-             << ", Type: " << (orderType == OrderType::GoodTillCancel ? "GTC" : "FAK") << endl;
+             << ", Type: " << orderTypeName(orderType) << endl;
         
-        auto order = make_shared<Order>(orderType, orderId, side, price, quantity);
+        auto order = make_shared<Order>(orderType, orderId, side, price, quantity, expiry);
         auto trades = orderbook.AddOrder(order);
         
         if (!trades.empty()) {
@@ -139,6 +162,36 @@ bool processCommand(const string& cmd, Orderbook& orderbook) {
             }
         }
     } 
+    else if (action == "session") {
+        Timestamp close;
+        if (!(ss >> close)) {
+            cout << "Error: Invalid session close time" << endl;
+            return true;
+        }
+        
+        cout << "GoodForDay orders now expire at " << close << endl;
+        orderbook.SetSessionClose(close);
+    } 
+    else if (action == "time") {
+        Timestamp now;
+        if (!(ss >> now)) {
+            cout << "Error: Invalid time" << endl;
+            return true;
+        }
+        
+        auto expired = orderbook.AdvanceTime(now);
+        cout << "Clock at " << orderbook.Now() << ", expired " << expired.size() << " order(s)" << endl;
+        for (OrderId orderId : expired) {
+            cout << "  Expired order ID: " << orderId << endl;
+        }
+    } 
+    else if (action == "stats") {
+        const auto& statistics = orderbook.GetTradeStatistics();
+        cout << "Last price: " << fixed << setprecision(2) << statistics.lastPrice
+             << ", VWAP: " << statistics.vwap
+             << ", Volume: " << statistics.volume
+             << ", Trades: " << statistics.tradeCount << endl;
+    } 
     else if (action == "clear") {
         cout << "Clearing all orders" << endl;
         orderbook.ClearAll();
@@ -150,7 +203,7 @@ bool processCommand(const string& cmd, Orderbook& orderbook) {
     return true;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         cout << "\n===== ORDERBOOK ENGINE =====\n" << endl;
         cout << "Welcome to the Orderbook Engine" << endl;
@@ -160,6 +213,14 @@ int main() {
         Orderbook orderbook;
         string command;
         
+        // Optionally record every execution to a columnar binary log
+        unique_ptr<ExecutionLogWriter> executionLog;
+        if (argc > 1) {
+            executionLog = make_unique<ExecutionLogWriter>(argv[1]);
+            orderbook.AttachExecutionLog(executionLog.get());
+            cout << "Recording executions to " << argv[1] << endl;
+        }
+        
         while (true) {
             printOrderBookSummary(orderbook);
             cout << "\nEnter command: ";
@@ -3,116 +3,128 @@
 #include <memory>
 #include <stdexcept>
 
-#include "Orderbook.h"
+#include "orderbook.h"
 #include "Order.h"
 #include "OrderModify.h"
 #include "Trade.h"
 
 using namespace std;
 
-bool Orderbook::CanMatch(BuyOrSell buyorsell, Price price) const {
+namespace {
+// Below this many tombstones compaction is never worth a pass over the book
+constexpr size_t MinCompaction = 64;
+}
+
+template <typename MatchingPolicy>
+BasicOrderbook<MatchingPolicy>::BasicOrderbook() : BasicOrderbook(OrderbookCapacity{}) {}
+
+template <typename MatchingPolicy>
+BasicOrderbook<MatchingPolicy>::BasicOrderbook(const PriceBand& band) : BasicOrderbook(OrderbookCapacity{}, band) {}
+
+template <typename MatchingPolicy>
+BasicOrderbook<MatchingPolicy>::BasicOrderbook(const OrderbookCapacity& capacity, const PriceBand& band)
+    : arena_{capacity.maxOrders ? make_unique<Arena>(ArenaBytes(capacity), capacity.hugePages, capacity.prefault) : nullptr},
+      band_{band},
+      bids_{OrderPointers::allocator_type(arena_.get())},
+      asks_{OrderPointers::allocator_type(arena_.get())},
+      orders{0, hash<OrderId>(), equal_to<OrderId>(), typename OrderIndex::allocator_type(arena_.get())} {
+    bids_.Configure(band);
+    asks_.Configure(band);
+    if (capacity.maxOrders) {
+        orders.reserve(capacity.maxOrders);
+        timers_.Reserve(capacity.maxOrders);
+    }
+}
+
+// Conservative footprint of every container node the book can hold at
+// capacity: payload plus links, rounded to the arena block size
+template <typename MatchingPolicy>
+size_t BasicOrderbook<MatchingPolicy>::ArenaBytes(const OrderbookCapacity& capacity) {
+    auto nodeBytes = [](size_t payload) {
+        return (payload + 4 * sizeof(void*) + Arena::Alignment - 1) / Arena::Alignment * Arena::Alignment;
+    };
+    size_t perOrder = nodeBytes(sizeof(RestingOrder))
+        + nodeBytes(sizeof(typename OrderIndex::value_type))
+        + 2 * sizeof(void*); // Hash buckets, with slack for prime rounding
+    size_t perLevel = nodeBytes(sizeof(pair<const Price, PriceLevel>));
+    return capacity.maxOrders * perOrder + 2 * capacity.maxLevels * perLevel + 64 * 1024;
+}
+
+template <typename MatchingPolicy>
+bool BasicOrderbook<MatchingPolicy>::CanMatch(BuyOrSell buyorsell, Price price) const {
     if (buyorsell == BuyOrSell::Buy) {
-        if (asks_.empty()) {
+        if (asks_.Empty()) {
             return false;
         }
-        const auto& [bestAsk, _] = *asks_.begin();
-        return price >= bestAsk;
+        return price >= asks_.Best().price;
     } else {
-        if (bids_.empty()) {
+        if (bids_.Empty()) {
             return false;
         }
-        const auto& [bestBid, _] = *bids_.begin();
-        return price <= bestBid;
+        return price <= bids_.Best().price;
     }
 }
 
-Trades Orderbook::MatchOrders() {
+// Allocates the incoming order across the best opposite levels for as long
+// as it crosses, letting the matching policy split each level in one pass.
+// The book was uncrossed before the order arrived, so it is the aggressor
+// in every trade.
+template <typename MatchingPolicy>
+Trades BasicOrderbook<MatchingPolicy>::MatchOrders(const OrderPointer& order) {
     Trades trades;
-    
-    if (orders.empty()) {
-        return trades;
-    }
+    BuyOrSell side = order->GetBuyOrSell();
+    OrderId orderId = order->GetOrderId();
     
     try {
-        // Matching logic
-        while (!bids_.empty() && !asks_.empty()) {
-            auto bidIt = bids_.begin();
-            auto askIt = asks_.begin();
+        while (!order->IsFilled() && CanMatch(side, order->GetPrice())) {
+            PriceLevel& level = side == BuyOrSell::Buy ? asks_.Best() : bids_.Best();
             
-            auto& [bidPrice, bids] = *bidIt;
-            auto& [askPrice, asks] = *askIt;
+            // Copy the price; erasing a level destroys it
+            Price levelPrice = level.price;
             
-            // No match possible if best bid < best ask
-            if (bidPrice < askPrice) {
+            allocations_.clear();
+            MatchingPolicy::Allocate(level.orders, level.quantity, order->GetRemainingQuantity(), allocations_);
+            if (allocations_.empty()) {
                 break;
             }
-
-            // Match orders at these price levels
-            while (!bids.empty() && !asks.empty()) {
-                auto bidOrderIt = bids.begin();
-                auto askOrderIt = asks.begin();
-                
-                // Get references to the orders
-                auto& bidOrder = *bidOrderIt;
-                auto& askOrder = *askOrderIt;
-                
-                // Check for invalid pointers
-                if (!bidOrder || !askOrder) {
-                    if (!bidOrder) bids.erase(bidOrderIt);
-                    if (!askOrder) asks.erase(askOrderIt);
-                    
-                    // If this emptied a list, clean up the price level
-                    if (bids.empty()) bids_.erase(bidPrice);
-                    if (asks.empty()) asks_.erase(askPrice);
-                    
-                    // If either side is now empty, break out of matching
-                    if (bids_.empty() || asks_.empty()) break;
-                    continue;
-                }
-                
-                // Store IDs early so we still have them after filling
-                OrderId bidId = bidOrder->GetOrderId();
-                OrderId askId = askOrder->GetOrderId();
-                
-                // Calculate match quantity
-                Quantity quantity = min(bidOrder->GetRemainingQuantity(), askOrder->GetRemainingQuantity());
+            
+            // Orders before this point have been swept by the allocation
+            OrderPointers::iterator swept = next(allocations_.back().order);
+            
+            for (const Allocation& allocation : allocations_) {
+                OrderPointer resting = allocation.order->order;
+                Quantity quantity = allocation.quantity;
                 
                 // Fill orders
-                bidOrder->Fill(quantity);
-                askOrder->Fill(quantity);
+                order->Fill(quantity);
+                resting->Fill(quantity);
+                level.quantity -= quantity;
                 
                 // Record the trade
-                trades.push_back(Trade{
-                    TradeInfo{ bidId, bidOrder->GetPrice(), quantity },
-                    TradeInfo{ askId, askOrder->GetPrice(), quantity }
-                });
-                
-                // Check if orders are now filled 
-                if (bidOrder->IsFilled()) {
-                    bids.erase(bidOrderIt); // Remove from price level
-                    orders.erase(bidId);    // Remove from lookup
-                    
-                    // If this price level is now empty, remove it
-                    if (bids.empty()) {
-                        bids_.erase(bidPrice);
-                        break; // Need to break as we've invalidated bidIt
-                    }
-                }
+                TradeInfo incoming{ orderId, order->GetPrice(), quantity };
+                TradeInfo opposite{ resting->GetOrderId(), resting->GetPrice(), quantity };
+                trades.push_back(side == BuyOrSell::Buy ? Trade{ incoming, opposite } : Trade{ opposite, incoming });
+                RecordTrade(trades.back(), side);
                 
-                if (askOrder->IsFilled()) {
-                    asks.erase(askOrderIt); // Remove from price level
-                    orders.erase(askId);    // Remove from lookup
-                    
-                    // If this price level is now empty, remove it
-                    if (asks.empty()) {
-                        asks_.erase(askPrice);
-                        break; // Need to break as we've invalidated askIt
-                    }
+                // Remove filled resting orders from their level and lookup
+                if (resting->IsFilled()) {
+                    level.orders.erase(allocation.order);
+                    EraseOrderEntry(resting->GetOrderId());
                 }
             }
             
-            // Need to break if we've emptied either side
-            if (bids_.empty() || asks_.empty()) break;
+            // If this price level has no live orders left, remove it along
+            // with any tombstones; otherwise reclaim those swept past
+            if (level.quantity == 0) {
+                tombstones_ -= level.tombstones;
+                if (side == BuyOrSell::Buy) {
+                    asks_.Erase(levelPrice);
+                } else {
+                    bids_.Erase(levelPrice);
+                }
+            } else if (level.tombstones > 0) {
+                ReclaimTombstones(level, swept);
+            }
         }
     }
     catch (const exception& e) {
@@ -122,41 +134,81 @@ Trades Orderbook::MatchOrders() {
     return trades;
 }
 
-Trades Orderbook::AddOrder(OrderPointer order) {
+template <typename MatchingPolicy>
+Trades BasicOrderbook<MatchingPolicy>::AddOrder(OrderPointer order) {
+    SnapshotScope scope(*this);
     if (!order) {
-        cout << "Ignoring null order" << endl;
+        if (diagnostics_) {
+            *diagnostics_ << "Ignoring null order" << endl;
+        }
         return {};
     }
 
     auto orderId = order->GetOrderId();
     if (orders.find(orderId) != orders.end()) {
-        cout << "Order " << orderId << " already exists" << endl;
+        if (diagnostics_) {
+            *diagnostics_ << "Order " << orderId << " already exists" << endl;
+        }
         return {};
     }
 
     if (order->GetOrderType() == OrderType::FillAndKill && !CanMatch(order->GetBuyOrSell(), order->GetPrice())) {
-        cout << "FillAndKill order " << orderId << " would not match, discarding" << endl;
+        if (diagnostics_) {
+            *diagnostics_ << "FillAndKill order " << orderId << " would not match, discarding" << endl;
+        }
+        return {};
+    }
+
+    // Resolve when a timed order expires; it must still be live now
+    Timestamp expiry = 0;
+    if (order->GetOrderType() == OrderType::GoodTillTime) {
+        expiry = order->GetExpiry();
+    } else if (order->GetOrderType() == OrderType::GoodForDay) {
+        expiry = sessionClose_;
+    }
+    bool timed = order->GetOrderType() == OrderType::GoodTillTime || order->GetOrderType() == OrderType::GoodForDay;
+    if (timed && expiry == 0) {
+        // Without an expiry the order would silently rest as GoodTillCancel
+        if (diagnostics_) {
+            *diagnostics_ << "Order " << orderId << " has no expiry (GoodForDay needs a session close), discarding" << endl;
+        }
+        return {};
+    }
+    if (expiry != 0 && expiry <= timers_.Now()) {
+        if (diagnostics_) {
+            *diagnostics_ << "Order " << orderId << " would expire immediately, discarding" << endl;
+        }
         return {};
     }
 
     try {
-        // Add to appropriate side
+        // Match against resting liquidity first
+        Trades trades = MatchOrders(order);
+        
+        // FillAndKill remainders never rest
+        if (order->IsFilled() || order->GetOrderType() == OrderType::FillAndKill) {
+            return trades;
+        }
+        
+        // Rest the remainder on the appropriate side
         OrderPointers::iterator itr;
         if (order->GetBuyOrSell() == BuyOrSell::Buy) {
-            auto& ordersAtPrice = bids_[order->GetPrice()];
-            ordersAtPrice.push_back(order);
-            itr = prev(ordersAtPrice.end());
+            PriceLevel& level = bids_.GetOrCreate(order->GetPrice());
+            level.orders.push_back(RestingOrder{order});
+            level.quantity += order->GetRemainingQuantity();
+            itr = prev(level.orders.end());
         } else {
-            auto& ordersAtPrice = asks_[order->GetPrice()];
-            ordersAtPrice.push_back(order);
-            itr = prev(ordersAtPrice.end());
+            PriceLevel& level = asks_.GetOrCreate(order->GetPrice());
+            level.orders.push_back(RestingOrder{order});
+            level.quantity += order->GetRemainingQuantity();
+            itr = prev(level.orders.end());
         }
         
-        // Store order in lookup map
-        orders.insert({orderId, OrderEntry{order, itr}});
+        // Store order in lookup map, arming its expiry timer if it has one
+        TimerWheel::Handle timer = expiry != 0 ? timers_.Schedule(orderId, expiry) : TimerWheel::InvalidHandle;
+        orders.insert({orderId, OrderEntry{order, itr, timer}});
         
-        // Try to match orders
-        return MatchOrders();
+        return trades;
     }
     catch (const exception& e) {
         cerr << "Error adding order: " << e.what() << endl;
@@ -164,7 +216,9 @@ Trades Orderbook::AddOrder(OrderPointer order) {
     }
 }
 
-void Orderbook::CancelOrder(OrderId orderId) {
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::CancelOrder(OrderId orderId) {
+    SnapshotScope scope(*this);
     try {
         // Find the order
         auto it = orders.find(orderId);
@@ -182,31 +236,39 @@ void Orderbook::CancelOrder(OrderId orderId) {
         // Get copies of all needed data BEFORE erasing
         OrderPointer order = entry.order;
         OrderPointers::iterator location = entry.location;
+        timers_.Cancel(entry.timer);
         BuyOrSell side = order->GetBuyOrSell();
         Price price = order->GetPrice();
         
         // Remove from orders map first
         orders.erase(it);
         
+        if (lazyCancel_) {
+            CancelLazily(order, location);
+            return;
+        }
+        
         // Now remove from the appropriate price level
         if (side == BuyOrSell::Buy) {
-            auto bidIt = bids_.find(price);
-            if (bidIt != bids_.end()) {
-                bidIt->second.erase(location);
+            if (PriceLevel* level = bids_.Find(price)) {
+                level->orders.erase(location);
+                level->quantity -= order->GetRemainingQuantity();
                 
-                // Clean up empty price levels
-                if (bidIt->second.empty()) {
-                    bids_.erase(bidIt);
+                // Clean up price levels with no live orders
+                if (level->quantity == 0) {
+                    tombstones_ -= level->tombstones;
+                    bids_.Erase(price);
                 }
             }
         } else { // Sell side
-            auto askIt = asks_.find(price);
-            if (askIt != asks_.end()) {
-                askIt->second.erase(location);
+            if (PriceLevel* level = asks_.Find(price)) {
+                level->orders.erase(location);
+                level->quantity -= order->GetRemainingQuantity();
                 
-                // Clean up empty price levels
-                if (askIt->second.empty()) {
-                    asks_.erase(askIt);
+                // Clean up price levels with no live orders
+                if (level->quantity == 0) {
+                    tombstones_ -= level->tombstones;
+                    asks_.Erase(price);
                 }
             }
         }
@@ -216,7 +278,9 @@ void Orderbook::CancelOrder(OrderId orderId) {
     }
 }
 
-Trades Orderbook::MatchOrder(OrderModify modOrder) {
+template <typename MatchingPolicy>
+Trades BasicOrderbook<MatchingPolicy>::MatchOrder(OrderModify modOrder) {
+    SnapshotScope scope(*this);
     try {
         // Find the original order
         auto orderId = modOrder.GetOrderId();
@@ -233,10 +297,11 @@ Trades Orderbook::MatchOrder(OrderModify modOrder) {
         }
         
         OrderType type = entry.order->GetOrderType();
+        Timestamp expiry = entry.order->GetExpiry();
         
         // Cancel the old order and add the new one
         CancelOrder(orderId);
-        return AddOrder(modOrder.ToOrderPointer(type));
+        return AddOrder(modOrder.ToOrderPointer(type, expiry));
     }
     catch (const exception& e) {
         cerr << "Error modifying order: " << e.what() << endl;
@@ -244,20 +309,288 @@ Trades Orderbook::MatchOrder(OrderModify modOrder) {
     }
 }
 
-size_t Orderbook::Size() const { 
+template <typename MatchingPolicy>
+size_t BasicOrderbook<MatchingPolicy>::Size() const { 
     return orders.size(); 
 }
 
-void Orderbook::ClearAll() {
-    bids_.clear();
-    asks_.clear();
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::ClearAll() {
+    SnapshotScope scope(*this);
+    bids_.Clear();
+    asks_.Clear();
     orders.clear();
+    timers_.Clear();
+    tombstones_ = 0;
 }
 
-OrderPointer Orderbook::FindOrder(OrderId orderid) const {
+template <typename MatchingPolicy>
+OrderPointer BasicOrderbook<MatchingPolicy>::FindOrder(OrderId orderid) const {
     auto it = orders.find(orderid);
     if (it != orders.end()) {
         return it->second.order;
     }
     return nullptr;
-} 
\ No newline at end of file
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::EraseOrderEntry(OrderId orderid) {
+    auto it = orders.find(orderid);
+    if (it == orders.end()) {
+        return;
+    }
+    timers_.Cancel(it->second.timer);
+    orders.erase(it);
+}
+
+// Leaves the order in its level as a tombstone. Only the level's live
+// quantity changes, so the level is released once nothing live remains.
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::CancelLazily(const OrderPointer& order, OrderPointers::iterator location) {
+    Price price = order->GetPrice();
+    auto bury = [this, &order, location, price](auto& levels) {
+        PriceLevel* level = levels.Find(price);
+        if (!level) {
+            return;
+        }
+        location->cancelled = true;
+        level->quantity -= order->GetRemainingQuantity();
+        ++level->tombstones;
+        ++tombstones_;
+        if (level->quantity == 0) {
+            tombstones_ -= level->tombstones;
+            levels.Erase(price);
+        }
+    };
+    if (order->GetBuyOrSell() == BuyOrSell::Buy) {
+        bury(bids_);
+    } else {
+        bury(asks_);
+    }
+
+    // Compacting only past a fixed fraction of dead orders keeps the cost
+    // of each pass proportional to the tombstones it reclaims
+    if (tombstones_ >= MinCompaction && tombstones_ > compactionRatio_ * (orders.size() + tombstones_)) {
+        CompactLevels();
+    }
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::ReclaimTombstones(PriceLevel& level, OrderPointers::iterator end) {
+    for (auto it = level.orders.begin(); it != end && level.tombstones > 0;) {
+        if (it->cancelled) {
+            it = level.orders.erase(it);
+            --level.tombstones;
+            --tombstones_;
+        } else {
+            ++it;
+        }
+    }
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::SetLazyCancel(bool enabled, double compactionRatio) {
+    lazyCancel_ = enabled;
+    compactionRatio_ = compactionRatio;
+    if (!enabled) {
+        CompactLevels();
+    }
+}
+
+template <typename MatchingPolicy>
+size_t BasicOrderbook<MatchingPolicy>::CompactLevels() {
+    if (tombstones_ == 0) {
+        return 0;
+    }
+    size_t reclaimed = 0;
+    auto compact = [&reclaimed](PriceLevel& level) {
+        if (level.tombstones > 0) {
+            level.orders.remove_if([](const RestingOrder& entry) { return entry.cancelled; });
+            reclaimed += level.tombstones;
+            level.tombstones = 0;
+        }
+        return true;
+    };
+    bids_.ForEachLevel(compact);
+    asks_.ForEachLevel(compact);
+    tombstones_ -= reclaimed;
+    return reclaimed;
+}
+
+template <typename MatchingPolicy>
+size_t BasicOrderbook<MatchingPolicy>::TombstoneCount() const {
+    return tombstones_;
+}
+
+template <typename MatchingPolicy>
+std::vector<OrderId> BasicOrderbook<MatchingPolicy>::AdvanceTime(Timestamp now) {
+    SnapshotScope scope(*this);
+    std::vector<OrderId> expired;
+    timers_.Advance(now, expired);
+
+    // The wheel has already released these timers
+    for (OrderId orderId : expired) {
+        auto it = orders.find(orderId);
+        if (it != orders.end()) {
+            it->second.timer = TimerWheel::InvalidHandle;
+            CancelOrder(orderId);
+        }
+    }
+    bars_.AdvanceTime(timers_.Now());
+    return expired;
+}
+
+template <typename MatchingPolicy>
+Timestamp BasicOrderbook<MatchingPolicy>::Now() const {
+    return timers_.Now();
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::SetSessionClose(Timestamp close) {
+    sessionClose_ = close;
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::RecenterPriceBand(Price basePrice) {
+    SnapshotScope scope(*this);
+    band_.basePrice = basePrice;
+    bids_.Recenter(basePrice);
+    asks_.Recenter(basePrice);
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::AttachSnapshotPublisher(SnapshotPublisher* publisher) {
+    publisher_ = publisher;
+    if (publisher_) {
+        publisher_->Publish(TakeSnapshot());
+    }
+}
+
+template <typename MatchingPolicy>
+BookSnapshot BasicOrderbook<MatchingPolicy>::TakeSnapshot() const {
+    BookSnapshot snapshot{};
+    snapshot.time = timers_.Now();
+
+    bids_.ForEachLevel([&snapshot](const PriceLevel& level) {
+        snapshot.bids[snapshot.bidDepth++] = DepthLevel{level.price, level.quantity, static_cast<uint32_t>(level.orders.size() - level.tombstones)};
+        return snapshot.bidDepth < BookSnapshot::Depth;
+    });
+    asks_.ForEachLevel([&snapshot](const PriceLevel& level) {
+        snapshot.asks[snapshot.askDepth++] = DepthLevel{level.price, level.quantity, static_cast<uint32_t>(level.orders.size() - level.tombstones)};
+        return snapshot.askDepth < BookSnapshot::Depth;
+    });
+
+    snapshot.orderCount = orders.size();
+    snapshot.bidLevelCount = bids_.Size();
+    snapshot.askLevelCount = asks_.Size();
+    const TradeStatistics& statistics = bars_.Statistics();
+    snapshot.tradeCount = statistics.tradeCount;
+    snapshot.tradedVolume = statistics.volume;
+    snapshot.lastTradePrice = statistics.lastPrice;
+    snapshot.vwap = statistics.vwap;
+    return snapshot;
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::WarmUp(size_t cycles) {
+    if (!orders.empty()) {
+        if (diagnostics_) {
+            *diagnostics_ << "Warm-up needs an empty book, skipping" << endl;
+        }
+        return;
+    }
+
+    // Detach readers and the log and keep statistics so none of this is observable
+    SnapshotPublisher* publisher = publisher_;
+    publisher_ = nullptr;
+    ExecutionLogWriter* executionLog = executionLog_;
+    executionLog_ = nullptr;
+    BarAggregator bars = std::move(bars_);
+    bars_ = BarAggregator{};
+
+    // Work around the middle of the dense band when there is one
+    Price tick = band_.levelCount ? band_.tickSize : 0.01L;
+    Price mid = band_.levelCount ? band_.basePrice + tick * static_cast<Price>(band_.levelCount / 2) : 100.0L;
+    const int depth = 8;
+    Timestamp start = timers_.Now();
+    OrderId id = 1;
+    for (size_t cycle = 0; cycle < cycles; ++cycle) {
+        OrderId first = id;
+
+        // A timed order outside the sweep, expired at the end of the cycle.
+        // Varying the horizon sends it through the wheel's lower levels.
+        Timestamp expiry = timers_.Now() + 1 + cycle % 4096;
+        AddOrder(make_shared<Order>(OrderType::GoodTillTime, id++, BuyOrSell::Buy, mid - (depth + 1) * tick, 10, expiry));
+        for (int level = 1; level <= depth; ++level) {
+            AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id++, BuyOrSell::Buy, mid - level * tick, 10));
+            AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id++, BuyOrSell::Sell, mid + level * tick, 10));
+        }
+        MatchOrder(OrderModify(first, BuyOrSell::Buy, mid - 2 * tick, 10));
+
+        // Sweep a few levels each way, then cancel whatever is left
+        AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id++, BuyOrSell::Buy, mid + 3 * tick, 25));
+        AddOrder(make_shared<Order>(OrderType::FillAndKill, id++, BuyOrSell::Sell, mid - 3 * tick, 25));
+        AdvanceTime(expiry);
+        for (OrderId orderId = first; orderId < id; ++orderId) {
+            CancelOrder(orderId);
+        }
+    }
+    ClearAll();
+    timers_.Reset(start);
+
+    bars_ = std::move(bars);
+    publisher_ = publisher;
+    executionLog_ = executionLog;
+}
+
+template <typename MatchingPolicy>
+BarAggregator& BasicOrderbook<MatchingPolicy>::GetBarAggregator() {
+    return bars_;
+}
+
+template <typename MatchingPolicy>
+const TradeStatistics& BasicOrderbook<MatchingPolicy>::GetTradeStatistics() const {
+    return bars_.Statistics();
+}
+
+// Trades execute at the resting order's price
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::RecordTrade(const Trade& trade, BuyOrSell aggressor) {
+    const TradeInfo& resting = aggressor == BuyOrSell::Buy ? trade.GetAskTrade() : trade.GetBidTrade();
+    bars_.OnTrade(timers_.Now(), resting.price, resting.quantity);
+    if (executionLog_) {
+        executionLog_->Append(Execution{bars_.Statistics().tradeCount, timers_.Now(), resting.price, resting.quantity,
+                                        aggressor, trade.GetBidTrade().orderid, trade.GetAskTrade().orderid});
+    }
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::AttachExecutionLog(ExecutionLogWriter* log) {
+    executionLog_ = log;
+}
+
+template <typename MatchingPolicy>
+void BasicOrderbook<MatchingPolicy>::SetDiagnostics(std::ostream* out) {
+    diagnostics_ = out;
+}
+
+template <typename MatchingPolicy>
+const Arena* BasicOrderbook<MatchingPolicy>::GetArena() const {
+    return arena_.get();
+}
+
+template <typename MatchingPolicy>
+BasicOrderbook<MatchingPolicy>::SnapshotScope::SnapshotScope(BasicOrderbook& book) : book{book} {
+    ++book.snapshotDepth_;
+}
+
+template <typename MatchingPolicy>
+BasicOrderbook<MatchingPolicy>::SnapshotScope::~SnapshotScope() {
+    if (--book.snapshotDepth_ == 0 && book.publisher_) {
+        book.publisher_->Publish(book.TakeSnapshot());
+    }
+}
+
+template class BasicOrderbook<FifoMatching>;
+template class BasicOrderbook<ProRataMatching>;
+template class BasicOrderbook<FifoProRataMatching<>>;
@@ -4,14 +4,43 @@
 #include "Order.h"
 #include "OrderModify.h"
 #include "Trade.h"
-#include <list>
-#include <map>
+#include "TimerWheel.h"
+#include "PriceLadder.h"
+#include "BookSnapshot.h"
+#include "Arena.h"
+#include "BarAggregator.h"
+#include "MatchingPolicy.h"
+#include "ExecutionLog.h"
+#include <iostream>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
-using OrderPointers = std::list<OrderPointer>;
+// Up-front sizing for a book. With maxOrders set, the order index, order
+// lists and level map nodes are all carved out of one arena reserved (and
+// optionally prefaulted) at construction, and a timer node is built for
+// every order.
+struct OrderbookCapacity {
+    size_t maxOrders = 0;
+    size_t maxLevels = 0; // Per side
+    bool hugePages = false;
+    bool prefault = true;
+};
 
-class Orderbook {
+// MatchingPolicy decides how an incoming order is allocated across the
+// resting orders of each level it crosses (see MatchingPolicy.h). Member
+// definitions live in orderbook.cpp, which instantiates the policies
+// shipped with the engine.
+template <typename MatchingPolicy = FifoMatching>
+class BasicOrderbook {
 public:
+    BasicOrderbook();
+    // Keep levels inside the band in dense tick-indexed ladders
+    explicit BasicOrderbook(const PriceBand& band);
+    explicit BasicOrderbook(const OrderbookCapacity& capacity, const PriceBand& band = PriceBand{});
+    BasicOrderbook(const BasicOrderbook&) = delete;
+    BasicOrderbook& operator=(const BasicOrderbook&) = delete;
+
     Trades AddOrder(OrderPointer order);
     void CancelOrder(OrderId orderid);
     Trades MatchOrder(OrderModify order);
@@ -21,18 +50,106 @@ public:
     // Find an order by ID (returns nullptr if not found)
     OrderPointer FindOrder(OrderId orderid) const;
 
+    // Advance the engine clock, cancelling every GoodTillTime/GoodForDay
+    // order that is due. Returns the IDs of the expired orders.
+    std::vector<OrderId> AdvanceTime(Timestamp now);
+    Timestamp Now() const;
+
+    // GoodForDay orders expire at the session close in effect when they rest;
+    // until a close is set they are rejected, as are GoodTillTime orders
+    // without an expiry
+    void SetSessionClose(Timestamp close);
+
+    // Move the dense price band so it starts at basePrice
+    void RecenterPriceBand(Price basePrice);
+
+    // Publish top-of-book depth and statistics to the publisher after every
+    // change to the book; readers on other threads use the publisher only.
+    // Pass nullptr to stop publishing.
+    void AttachSnapshotPublisher(SnapshotPublisher* publisher);
+    BookSnapshot TakeSnapshot() const;
+
+    // Running last price / VWAP / volume and OHLCV bars built from every
+    // execution as it happens; configure intervals and callbacks here
+    BarAggregator& GetBarAggregator();
+    const TradeStatistics& GetTradeStatistics() const;
+
+    // Append every execution to a columnar log; match IDs follow the trade
+    // count. The book does not own the log. Pass nullptr to stop logging.
+    void AttachExecutionLog(ExecutionLogWriter* log);
+
+    // Run synthetic add/match/cancel/expiry cycles to prime caches, branch
+    // predictors and the arena free lists, then reset to an empty book.
+    // Trade statistics, the clock and attached readers are unaffected.
+    void WarmUp(size_t cycles);
+
+    // Notices about rejected orders go to this stream (cout by default);
+    // nullptr silences them, e.g. when replaying sessions in bulk
+    void SetDiagnostics(std::ostream* out);
+
+    // Arena backing the book's containers (nullptr without a capacity)
+    const Arena* GetArena() const;
+
+    // In lazy-cancel mode CancelOrder only drops the order from the index,
+    // takes its quantity off the level and leaves it in the level's list as
+    // a tombstone. Matching reclaims tombstones it sweeps past; the rest are
+    // compacted once they exceed compactionRatio of the orders held in
+    // levels, or whenever CompactLevels() is called (e.g. when idle).
+    // Turning the mode off compacts immediately.
+    void SetLazyCancel(bool enabled, double compactionRatio = 0.5);
+    size_t CompactLevels();
+    size_t TombstoneCount() const;
+
 private:
     struct OrderEntry {
         OrderPointer order;
         OrderPointers::iterator location;
+        TimerWheel::Handle timer;
+    };
+
+    // Publishes once the outermost public operation finishes, so readers
+    // never see the intermediate state of a cancel-and-replace
+    struct SnapshotScope {
+        explicit SnapshotScope(BasicOrderbook& book);
+        ~SnapshotScope();
+        BasicOrderbook& book;
     };
 
-    std::map<Price, OrderPointers, std::greater<Price>> bids_;
-    std::map<Price, OrderPointers, std::less<Price>> asks_;
-    std::unordered_map<OrderId, OrderEntry> orders;
+    using OrderIndex = std::unordered_map<OrderId, OrderEntry, std::hash<OrderId>, std::equal_to<OrderId>,
+                                          ArenaAllocator<std::pair<const OrderId, OrderEntry>>>;
+
+    std::unique_ptr<Arena> arena_;
+    PriceBand band_;
+    PriceLevels<std::greater<Price>> bids_;
+    PriceLevels<std::less<Price>> asks_;
+    OrderIndex orders;
+    TimerWheel timers_;
+    Timestamp sessionClose_ = 0;
+    SnapshotPublisher* publisher_ = nullptr;
+    ExecutionLogWriter* executionLog_ = nullptr;
+    std::ostream* diagnostics_ = &std::cout;
+    int snapshotDepth_ = 0;
+    BarAggregator bars_;
+    std::vector<Allocation> allocations_;
+    bool lazyCancel_ = false;
+    double compactionRatio_ = 0.5;
+    size_t tombstones_ = 0;
 
+    static size_t ArenaBytes(const OrderbookCapacity& capacity);
     bool CanMatch(BuyOrSell buyorsell, Price price) const;
-    Trades MatchOrders();
+    Trades MatchOrders(const OrderPointer& order);
+    void RecordTrade(const Trade& trade, BuyOrSell aggressor);
+    void EraseOrderEntry(OrderId orderid);
+    void CancelLazily(const OrderPointer& order, OrderPointers::iterator location);
+    void ReclaimTombstones(PriceLevel& level, OrderPointers::iterator end);
 };
 
+extern template class BasicOrderbook<FifoMatching>;
+extern template class BasicOrderbook<ProRataMatching>;
+extern template class BasicOrderbook<FifoProRataMatching<>>;
+
+using Orderbook = BasicOrderbook<FifoMatching>;
+using ProRataOrderbook = BasicOrderbook<ProRataMatching>;
+using FifoProRataOrderbook = BasicOrderbook<FifoProRataMatching<>>;
+
 #endif // ORDERBOOK_H
\ No newline at end of file
@@ -2,11 +2,25 @@
 #include <memory>
 #include <vector>
 #include <iomanip>
+#include <chrono>
+#include <random>
+#include <set>
+#include <map>
+#include <filesystem>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 
 #include "Order.h"
 #include "OrderModify.h"
 #include "Trade.h"
-#include "Orderbook.h"
+#include "orderbook.h"
+#include "Backtest.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
@@ -35,6 +49,14 @@ void printTrade(const Trade& trade) {
     cout << "----------------------" << endl;
 }
 
+// Helper to fail the run when an expectation does not hold
+void check(bool condition, const string& message) {
+    if (!condition) {
+        throw runtime_error("Check failed: " + message);
+    }
+    cout << "  OK: " << message << endl;
+}
+
 // Test the Order class functionality
 void testOrderClass() {
     cout << "\n===== TESTING ORDER CLASS =====\n" << endl;
@@ -198,6 +220,700 @@ void testOrderMatching() {
     cout << "Final orderbook size: " << orderbook.Size() << endl;
 }
 
+// Test GoodTillTime / GoodForDay expiry
+void testTimedOrders() {
+    cout << "\n===== TESTING TIMED ORDER EXPIRY =====\n" << endl;
+    
+    Orderbook orderbook;
+    orderbook.AdvanceTime(1000);
+    
+    cout << "Adding a GFD order before any session close and a GTT order without expiry" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodForDay, 90, BuyOrSell::Sell, 104.00, 10));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 91, BuyOrSell::Sell, 104.00, 10));
+    check(orderbook.Size() == 0, "timed orders without an expiry are rejected");
+    orderbook.SetSessionClose(5000);
+    
+    
+    cout << "Adding GTT orders expiring at 1100 and 1200, a far-dated GTT and a GFD order" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 1, BuyOrSell::Buy, 99.00, 10, 1100));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 2, BuyOrSell::Buy, 98.00, 10, 1200));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 3, BuyOrSell::Sell, 105.00, 10, 3000000000ULL));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodForDay, 4, BuyOrSell::Sell, 104.00, 10));
+    check(orderbook.Size() == 4, "four timed orders resting");
+    
+    cout << "\nAdding GTT order that has already expired" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 5, BuyOrSell::Buy, 97.00, 10, 900));
+    check(orderbook.Size() == 4, "expired GTT order discarded");
+    
+    cout << "\nFilling GTT order 2 partially and cancelling order 1" << endl;
+    orderbook.CancelOrder(1);
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 6, BuyOrSell::Sell, 98.00, 4));
+    
+    auto expired = orderbook.AdvanceTime(1150);
+    check(expired.empty(), "cancelled order does not expire");
+    expired = orderbook.AdvanceTime(1200);
+    check(expired.size() == 1 && expired[0] == 2, "partially filled GTT order expires at 1200");
+    
+    cout << "\nAdvancing to the session close" << endl;
+    expired = orderbook.AdvanceTime(5000);
+    check(expired.size() == 1 && expired[0] == 4, "GFD order expires at session close");
+    
+    cout << "\nAdding GTT order filled before its expiry" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 7, BuyOrSell::Buy, 105.00, 6, 9000));
+    check(orderbook.FindOrder(7) == nullptr, "filled GTT order leaves the book");
+    cout << "\nFilling a resting order and the incoming order exactly" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 8, BuyOrSell::Sell, 104.50, 5, 9000));
+    auto exact = orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 9, BuyOrSell::Buy, 104.50, 5));
+    check(exact.size() == 1 && !orderbook.FindOrder(8) && !orderbook.FindOrder(9), "both filled orders leave the book");
+    check(orderbook.TakeSnapshot().askLevelCount == 1, "emptied level removed");
+    
+    // Order 3 must still rest, partially filled, for the far-dated expiry below
+    check(orderbook.FindOrder(3) && orderbook.FindOrder(3)->GetRemainingQuantity() == 4, "far-dated order partially filled");
+    expired = orderbook.AdvanceTime(10000);
+    check(expired.empty(), "filled GTT order does not expire");
+    
+    expired = orderbook.AdvanceTime(3000000000ULL);
+    check(expired.size() == 1 && expired[0] == 3, "far-dated GTT order expires beyond the wheel range");
+    check(orderbook.Size() == 0, "book empty after expiry");
+    
+    cout << "\nEnd-of-day expiry of 200000 GFD orders" << endl;
+    orderbook.ClearAll();
+    orderbook.SetSessionClose(3086400000ULL);
+    for (OrderId id = 100; id < 200100; ++id) {
+        BuyOrSell side = (id % 2 == 0) ? BuyOrSell::Buy : BuyOrSell::Sell;
+        Price price = side == BuyOrSell::Buy ? 90.00 - (id % 50) * 0.01 : 110.00 + (id % 50) * 0.01;
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodForDay, id, side, price, 1));
+    }
+    auto start = chrono::steady_clock::now();
+    expired = orderbook.AdvanceTime(3086400000ULL);
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+    cout << "  Expired " << expired.size() << " orders in " << elapsed.count() / 1000.0 << " ms" << endl;
+    check(expired.size() == 200000 && orderbook.Size() == 0, "all GFD orders expired in one batch");
+    
+    cout << "\nCancelling the only far-dated timer, then scheduling another" << endl;
+    {
+        const Timestamp block = Timestamp{1} << 30;
+        TimerWheel wheel;
+        vector<OrderId> due;
+        wheel.Cancel(wheel.Schedule(1, block + 10));
+        wheel.Advance(block + 1000, due);
+        wheel.Schedule(2, 5 * block);
+        uint64_t steps = wheel.Steps();
+        wheel.Advance(2 * block - 1, due);
+        check(due.empty() && wheel.Steps() - steps <= 8, "clock skips ahead with one far timer pending");
+        wheel.Advance(5 * block, due);
+        check(due.size() == 1 && due[0] == 2 && wheel.Steps() - steps <= 16, "far timer fires at its expiry");
+        
+        Orderbook book;
+        book.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 1, BuyOrSell::Buy, 99.00, 10, block + 10));
+        book.CancelOrder(1);
+        book.AdvanceTime(block + 1000);
+        book.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 2, BuyOrSell::Buy, 99.00, 10, 5 * block));
+        check(book.AdvanceTime(2 * block - 1).empty() && book.Size() == 1, "order still resting before its expiry");
+        expired = book.AdvanceTime(5 * block);
+        check(expired.size() == 1 && expired[0] == 2, "order expires at its expiry");
+    }
+}
+
+// Test the dense price ladder and its fallback to the overflow map
+void testDensePriceLadder() {
+    cout << "\n===== TESTING DENSE PRICE LADDER =====\n" << endl;
+    
+    cout << "Comparing ladder bitmap searches against a reference set" << endl;
+    PriceLadder ladder;
+    ladder.Configure(PriceBand{0.01, 0.00, 100000});
+    set<size_t> reference;
+    mt19937 rng(7);
+    for (int step = 0; step < 20000; ++step) {
+        size_t index = rng() % 100000;
+        if (reference.count(index)) {
+            ladder.Release(index);
+            reference.erase(index);
+        } else {
+            ladder.Occupy(index, index * 0.01);
+            reference.insert(index);
+        }
+    }
+    bool matches = ladder.Lowest() == *reference.begin() && ladder.Highest() == *reference.rbegin();
+    size_t index = ladder.Lowest();
+    for (size_t expected : reference) {
+        matches = matches && index == expected;
+        index = ladder.NextAbove(index);
+    }
+    matches = matches && index == PriceLadder::NoLevel;
+    index = ladder.Highest();
+    for (auto it = reference.rbegin(); it != reference.rend(); ++it) {
+        matches = matches && index == *it;
+        index = ladder.NextBelow(index);
+    }
+    check(matches && index == PriceLadder::NoLevel, "lowest/highest/next searches agree with reference");
+    
+    cout << "\nCreating orderbook with band 99.00 - 100.99 (tick 0.01)" << endl;
+    Orderbook orderbook(PriceBand{0.01, 99.00, 200});
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 1, BuyOrSell::Buy, 100.50, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 2, BuyOrSell::Buy, 101.50, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 3, BuyOrSell::Buy, 99.25, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 4, BuyOrSell::Buy, 98.00, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 5, BuyOrSell::Buy, 100.505, 5));
+    
+    cout << "Selling through every bid level" << endl;
+    auto trades = orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Sell, 98.00, 25));
+    vector<OrderId> fills;
+    for (const auto& trade : trades) {
+        fills.push_back(trade.GetBidTrade().orderid);
+    }
+    check(fills == vector<OrderId>({2, 5, 1, 3, 4}), "bids fill best-first across ladder and overflow levels");
+    check(orderbook.Size() == 0, "all levels emptied");
+    
+    cout << "\nResting asks in and out of band, then recentering to 100.00" << endl;
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 20, BuyOrSell::Sell, 100.90, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 21, BuyOrSell::Sell, 101.20, 5));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 22, BuyOrSell::Sell, 99.50, 5));
+    orderbook.RecenterPriceBand(100.00);
+    orderbook.CancelOrder(21);
+    check(orderbook.Size() == 2, "cancel works on a level moved into the band");
+    trades = orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 23, BuyOrSell::Buy, 101.00, 10));
+    check(trades.size() == 2 && trades[0].GetAskTrade().orderid == 22 && trades[1].GetAskTrade().orderid == 20,
+          "asks fill lowest-first after recentering");
+    check(orderbook.Size() == 0, "book empty after sweep");
+}
+
+// Test seqlock-published snapshots read by several threads under load
+void testConcurrentSnapshots() {
+    cout << "\n===== TESTING CONCURRENT SNAPSHOTS =====\n" << endl;
+    
+    Orderbook orderbook(PriceBand{1.00, 90.00, 32});
+    SnapshotPublisher publisher;
+    orderbook.AttachSnapshotPublisher(&publisher);
+    
+    atomic<bool> done{false};
+    atomic<uint64_t> snapshotsRead{0};
+    atomic<uint64_t> inconsistent{0};
+    vector<thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastSequence = 0;
+            while (!done.load(memory_order_relaxed)) {
+                BookSnapshot snapshot = publisher.Read();
+                
+                // Every level fits in the depth, so a torn copy shows up
+                // as counts that do not add up or an unordered ladder
+                uint64_t orderCount = 0;
+                bool ok = snapshot.sequence >= lastSequence
+                    && snapshot.bidDepth == snapshot.bidLevelCount
+                    && snapshot.askDepth == snapshot.askLevelCount;
+                for (uint32_t i = 0; i < snapshot.bidDepth; ++i) {
+                    orderCount += snapshot.bids[i].orderCount;
+                    ok = ok && (i == 0 || snapshot.bids[i].price < snapshot.bids[i - 1].price);
+                }
+                for (uint32_t i = 0; i < snapshot.askDepth; ++i) {
+                    orderCount += snapshot.asks[i].orderCount;
+                    ok = ok && (i == 0 || snapshot.asks[i].price > snapshot.asks[i - 1].price);
+                }
+                ok = ok && orderCount == snapshot.orderCount;
+                if (snapshot.bidDepth > 0 && snapshot.askDepth > 0) {
+                    ok = ok && snapshot.bids[0].price < snapshot.asks[0].price;
+                }
+                if (!ok) {
+                    inconsistent.fetch_add(1, memory_order_relaxed);
+                }
+                lastSequence = snapshot.sequence;
+                snapshotsRead.fetch_add(1, memory_order_relaxed);
+            }
+        });
+    }
+    
+    cout << "Running 200000 add/cancel/cross operations against 4 readers" << endl;
+    mt19937 rng(42);
+    OrderId nextId = 1;
+    for (int step = 0; step < 200000; ++step) {
+        unsigned action = rng() % 10;
+        if (action < 5) {
+            BuyOrSell side = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+            Price price = side == BuyOrSell::Buy ? 95.00 + rng() % 5 : 101.00 + rng() % 5;
+            orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, nextId++, side, price, 1 + rng() % 10));
+        } else if (action < 9) {
+            orderbook.CancelOrder(1 + rng() % nextId);
+        } else {
+            BuyOrSell side = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+            Price price = side == BuyOrSell::Buy ? 101.00 : 99.00;
+            orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, nextId++, side, price, 1 + rng() % 10));
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    
+    BookSnapshot last = publisher.Read();
+    BookSnapshot current = orderbook.TakeSnapshot();
+    cout << "  Snapshots read: " << snapshotsRead.load() << ", publications: " << publisher.Sequence()
+         << ", trades: " << last.tradeCount << endl;
+    check(inconsistent.load() == 0, "every snapshot read was internally consistent");
+    check(last.orderCount == current.orderCount && last.tradeCount == current.tradeCount && last.tradeCount > 0,
+          "final snapshot matches the book");
+}
+
+// Test capacity reservation, arena-backed storage and warm-up
+void testCapacityAndWarmUp() {
+    cout << "\n===== TESTING CAPACITY RESERVATION AND WARM-UP =====\n" << endl;
+    
+    Orderbook plain;
+    check(plain.GetArena() == nullptr, "books without a capacity use the global heap");
+    
+    cout << "Creating orderbook for 100000 orders / 4000 levels, prefaulted, huge pages requested" << endl;
+    OrderbookCapacity capacity;
+    capacity.maxOrders = 100000;
+    capacity.maxLevels = 4000;
+    capacity.hugePages = true;
+    Orderbook orderbook(capacity, PriceBand{0.01, 80.00, 4000});
+    const Arena* arena = orderbook.GetArena();
+    check(arena != nullptr && arena->Capacity() > 0, "arena reserved up front");
+    cout << "  Arena: " << arena->Capacity() / 1024 << " KiB, huge pages: " << (arena->HugePages() ? "yes" : "no") << endl;
+    
+    orderbook.AdvanceTime(1000);
+    SnapshotPublisher publisher;
+    orderbook.AttachSnapshotPublisher(&publisher);
+    uint64_t sequence = publisher.Sequence();
+    
+    cout << "\nWarming up with 2000 cycles" << endl;
+    orderbook.WarmUp(2000);
+    BookSnapshot snapshot = orderbook.TakeSnapshot();
+    check(orderbook.Size() == 0 && snapshot.bidLevelCount == 0 && snapshot.askLevelCount == 0, "book empty after warm-up");
+    check(snapshot.tradeCount == 0 && publisher.Sequence() == sequence, "warm-up is invisible to statistics and readers");
+    check(orderbook.Now() == 1000, "warm-up leaves the clock where it was");
+    
+    cout << "\nFilling the book to capacity" << endl;
+    auto start = chrono::steady_clock::now();
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 1, BuyOrSell::Buy, 90.00, 10));
+    auto first = chrono::steady_clock::now() - start;
+    for (OrderId id = 2; id <= 100000; ++id) {
+        BuyOrSell side = id % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+        Price price = side == BuyOrSell::Buy ? 90.00 - (id % 1000) * 0.01 : 100.00 + (id % 1000) * 0.01;
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, side, price, 10));
+    }
+    cout << "  First order took " << chrono::duration_cast<chrono::nanoseconds>(first).count() << " ns" << endl;
+    check(orderbook.Size() == 100000, "book holds its full capacity");
+    check(arena->FallbackAllocations() == 0, "no allocation spilled out of the arena");
+    
+    orderbook.ClearAll();
+    check(orderbook.Size() == 0, "book cleared back into the arena");
+    
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillTime, 1, BuyOrSell::Buy, 90.00, 10, 1500));
+    vector<OrderId> expired = orderbook.AdvanceTime(1500);
+    check(expired.size() == 1 && expired[0] == 1 && orderbook.Size() == 0, "timed orders expire after warm-up");
+}
+
+// Test running trade statistics and OHLCV bar aggregation
+void testTradeBars() {
+    cout << "\n===== TESTING TRADE BARS =====\n" << endl;
+    
+    Orderbook orderbook;
+    BarAggregator& bars = orderbook.GetBarAggregator();
+    bars.AddInterval(1000);
+    bars.AddInterval(10000);
+    vector<Bar> longBars;
+    
+    cout << "Trading 3 times in the first second and once in the third" << endl;
+    orderbook.AdvanceTime(500);
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 1, BuyOrSell::Sell, 100.00, 10));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 2, BuyOrSell::Sell, 102.00, 10));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 3, BuyOrSell::Buy, 101.00, 4));
+    orderbook.AdvanceTime(700);
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 4, BuyOrSell::Buy, 103.00, 8));
+    orderbook.AdvanceTime(2500);
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 5, BuyOrSell::Buy, 99.00, 20));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 6, BuyOrSell::Sell, 98.00, 5));
+    
+    const TradeStatistics& statistics = orderbook.GetTradeStatistics();
+    cout << "  Last: " << statistics.lastPrice << ", VWAP: " << statistics.vwap
+         << ", Volume: " << statistics.volume << ", Trades: " << statistics.tradeCount << endl;
+    check(statistics.tradeCount == 4 && statistics.volume == 17, "running volume and trade count");
+    check(statistics.lastPrice == 99.00L, "trades print at the resting order's price");
+    check(fabsl(statistics.vwap - (4 * 100.00L + 6 * 100.00L + 2 * 102.00L + 5 * 99.00L) / 17) < 1e-9L, "running VWAP");
+    
+    auto completed = bars.TakeCompletedBars();
+    check(completed.size() == 1, "first one-second bar completed by a later trade");
+    const Bar& bar = completed[0];
+    check(bar.start == 0 && bar.open == 100.00L && bar.high == 102.00L && bar.low == 100.00L && bar.close == 102.00L
+          && bar.volume == 12 && bar.tradeCount == 3, "one-second OHLCV bar");
+    
+    cout << "\nSwitching to a callback and advancing past the ten-second bar" << endl;
+    bars.SetCallback([&longBars](const Bar& completedBar) { longBars.push_back(completedBar); });
+    orderbook.AdvanceTime(10000);
+    check(longBars.size() == 2, "clock advance closes the open bars of every interval");
+    Bar tenSecond = longBars[0].interval == 10000 ? longBars[0] : longBars[1];
+    check(tenSecond.volume == 17 && tenSecond.tradeCount == 4 && tenSecond.close == 99.00L,
+          "ten-second bar covers every trade");
+    check(fabsl(tenSecond.vwap - statistics.vwap) < 1e-9L, "bar VWAP matches the running VWAP");
+    
+    Bar current;
+    check(!bars.CurrentBar(1000, current), "no bar is open without new trades");
+}
+
+// Helper to collect per-order fill quantities from a trade list
+map<OrderId, Quantity> fillsByAsk(const Trades& trades) {
+    map<OrderId, Quantity> fills;
+    for (const auto& trade : trades) {
+        fills[trade.GetAskTrade().orderid] += trade.GetAskTrade().quantity;
+    }
+    return fills;
+}
+
+// Test the pro-rata and FIFO/pro-rata matching policies
+template <typename Book>
+void restThreeAsks(Book& orderbook) {
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 1, BuyOrSell::Sell, 100.00, 10));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 2, BuyOrSell::Sell, 100.00, 30));
+    orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 3, BuyOrSell::Sell, 100.00, 60));
+}
+
+void testMatchingPolicies() {
+    cout << "\n===== TESTING MATCHING POLICIES =====\n" << endl;
+    
+    cout << "Pro-rata: asks of 10, 30, 60 at 100.00 hit by a buy of 50" << endl;
+    {
+        ProRataOrderbook orderbook;
+        restThreeAsks(orderbook);
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 50)));
+        check(fills[1] == 5 && fills[2] == 15 && fills[3] == 30, "allocations proportional to resting size");
+        check(orderbook.TakeSnapshot().asks[0].quantity == 50, "level quantity reduced by the allocation");
+    }
+    
+    cout << "\nPro-rata: same level hit by a buy of 7" << endl;
+    {
+        ProRataOrderbook orderbook;
+        restThreeAsks(orderbook);
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 7)));
+        check(fills[1] == 1 && fills[2] == 2 && fills[3] == 4, "rounding remainder goes out in time priority");
+    }
+    
+    cout << "\nPro-rata: buy of 150 sweeps the level and rests the rest" << endl;
+    {
+        ProRataOrderbook orderbook;
+        restThreeAsks(orderbook);
+        auto trades = orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 150));
+        check(trades.size() == 3 && orderbook.Size() == 1, "whole level filled");
+        check(orderbook.FindOrder(10)->GetRemainingQuantity() == 50, "aggressor remainder rests");
+    }
+    
+    cout << "\nFIFO 40% then pro-rata: same level hit by a buy of 50" << endl;
+    {
+        FifoProRataOrderbook orderbook;
+        restThreeAsks(orderbook);
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 50)));
+        check(fills[1] == 10 && fills[2] == 18 && fills[3] == 22, "FIFO share first, remainder pro-rata");
+    }
+    
+    cout << "\nPro-rata across two levels" << endl;
+    {
+        ProRataOrderbook orderbook;
+        restThreeAsks(orderbook);
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 4, BuyOrSell::Sell, 101.00, 20));
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 5, BuyOrSell::Sell, 101.00, 20));
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 101.00, 110)));
+        check(fills[3] == 60 && fills[4] == 5 && fills[5] == 5, "best level filled before the next is shared");
+        check(orderbook.Size() == 2, "partially filled orders remain");
+    }
+}
+
+// Helper comparing the visible depth of two books level by level
+bool sameDepth(const BookSnapshot& a, const BookSnapshot& b) {
+    if (a.bidDepth != b.bidDepth || a.askDepth != b.askDepth || a.orderCount != b.orderCount ||
+        a.bidLevelCount != b.bidLevelCount || a.askLevelCount != b.askLevelCount) {
+        return false;
+    }
+    auto sameLevel = [](const DepthLevel& x, const DepthLevel& y) {
+        return x.price == y.price && x.quantity == y.quantity && x.orderCount == y.orderCount;
+    };
+    for (size_t i = 0; i < a.bidDepth; ++i) {
+        if (!sameLevel(a.bids[i], b.bids[i])) return false;
+    }
+    for (size_t i = 0; i < a.askDepth; ++i) {
+        if (!sameLevel(a.asks[i], b.asks[i])) return false;
+    }
+    return true;
+}
+
+// Test lazy-cancel mode, tombstone reclamation and compaction
+void testLazyCancel() {
+    cout << "\n===== TESTING LAZY CANCEL =====\n" << endl;
+    
+    cout << "Five asks at 100.00, cancelling the 2nd and 4th" << endl;
+    {
+        Orderbook orderbook;
+        orderbook.SetLazyCancel(true);
+        for (OrderId id = 1; id <= 5; ++id) {
+            orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, BuyOrSell::Sell, 100.00, 10));
+        }
+        orderbook.CancelOrder(2);
+        orderbook.CancelOrder(4);
+        BookSnapshot snapshot = orderbook.TakeSnapshot();
+        check(orderbook.Size() == 3 && orderbook.TombstoneCount() == 2, "cancelled orders become tombstones");
+        check(orderbook.FindOrder(2) == nullptr, "tombstones are gone from the index");
+        check(snapshot.asks[0].quantity == 30 && snapshot.asks[0].orderCount == 3, "level counts only live orders");
+        
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 25)));
+        check(fills.size() == 3 && fills[1] == 10 && fills[3] == 10 && fills[5] == 5, "matching skips tombstones");
+        check(orderbook.TombstoneCount() == 0, "tombstones swept by matching are reclaimed");
+        check(orderbook.TakeSnapshot().asks[0].quantity == 5, "level quantity stays exact");
+        
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 11, BuyOrSell::Sell, 101.00, 10));
+        orderbook.CancelOrder(11);
+        check(orderbook.TakeSnapshot().askLevelCount == 1 && orderbook.TombstoneCount() == 0,
+              "level with no live orders is released at once");
+    }
+    
+    cout << "\nPro-rata level with a tombstone" << endl;
+    {
+        ProRataOrderbook orderbook;
+        orderbook.SetLazyCancel(true);
+        restThreeAsks(orderbook);
+        orderbook.CancelOrder(2);
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 35)));
+        check(fills.size() == 2 && fills[1] == 5 && fills[3] == 30, "shares are taken over live orders only");
+    }
+
+    cout << "\nRe-adding a lazily cancelled order" << endl;
+    {
+        Orderbook orderbook;
+        orderbook.SetLazyCancel(true);
+        OrderPointer first = make_shared<Order>(OrderType::GoodTillCancel, 1, BuyOrSell::Sell, 100.00, 10);
+        orderbook.AddOrder(first);
+        orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 2, BuyOrSell::Sell, 100.00, 10));
+        orderbook.CancelOrder(1);
+        orderbook.AddOrder(first);
+        check(orderbook.Size() == 2 && orderbook.TombstoneCount() == 1, "re-added order rests behind its tombstone");
+
+        auto fills = fillsByAsk(orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, 10, BuyOrSell::Buy, 100.00, 20)));
+        check(fills.size() == 2 && fills[2] == 10 && fills[1] == 10, "re-added order is matched");
+        BookSnapshot snapshot = orderbook.TakeSnapshot();
+        check(orderbook.Size() == 0 && snapshot.askLevelCount == 0 && snapshot.bidLevelCount == 0, "book is left empty");
+    }
+
+    cout << "\nCancelling 900 of 1000 resting bids" << endl;
+    {
+        Orderbook orderbook;
+        orderbook.SetLazyCancel(true);
+        for (OrderId id = 1; id <= 1000; ++id) {
+            orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, BuyOrSell::Buy, 90.00 + (id % 10) * 0.01, 10));
+        }
+        for (OrderId id = 1; id <= 900; ++id) {
+            orderbook.CancelOrder(id);
+        }
+        cout << "  Tombstones left after threshold compaction: " << orderbook.TombstoneCount() << endl;
+        check(orderbook.Size() == 100 && orderbook.TombstoneCount() < 100, "compaction runs past the dead ratio");
+        uint64_t total = 0;
+        for (const auto& level : orderbook.TakeSnapshot().bids) {
+            total += level.quantity;
+        }
+        check(total == 1000, "level quantities stay exact");
+        size_t reclaimed = orderbook.CompactLevels();
+        check(orderbook.TombstoneCount() == 0 && reclaimed < 100, "idle compaction reclaims the rest");
+    }
+    
+    cout << "\nRandom flow against an eagerly cancelling book" << endl;
+    {
+        Orderbook eager;
+        Orderbook lazy(PriceBand{0.01, 95.00, 1000});
+        lazy.SetLazyCancel(true, 0.9);
+        mt19937_64 rng(32);
+        vector<OrderId> placed;
+        bool same = true;
+        for (OrderId id = 1; id <= 20000 && same; ++id) {
+            if (!placed.empty() && rng() % 100 < 70) {
+                OrderId victim = placed[rng() % placed.size()];
+                eager.CancelOrder(victim);
+                lazy.CancelOrder(victim);
+            }
+            BuyOrSell side = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+            Price price = 99.90 + static_cast<int>(rng() % 20) * 0.01;
+            Quantity quantity = 1 + rng() % 50;
+            Trades a = eager.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, side, price, quantity));
+            Trades b = lazy.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, side, price, quantity));
+            placed.push_back(id);
+            same = a.size() == b.size() && eager.Size() == lazy.Size();
+            for (size_t i = 0; same && i < a.size(); ++i) {
+                same = a[i].GetBidTrade().orderid == b[i].GetBidTrade().orderid &&
+                       a[i].GetAskTrade().orderid == b[i].GetAskTrade().orderid &&
+                       a[i].GetBidTrade().quantity == b[i].GetBidTrade().quantity;
+            }
+            same = same && sameDepth(eager.TakeSnapshot(), lazy.TakeSnapshot());
+        }
+        cout << "  Tombstones outstanding: " << lazy.TombstoneCount() << endl;
+        check(same, "trades and depth identical to eager cancellation");
+    }
+}
+
+// Test the columnar execution log writer and reader
+void testExecutionLog() {
+    cout << "\n===== TESTING EXECUTION LOG =====\n" << endl;
+    
+    string path = (filesystem::temp_directory_path() / "orderbook_test_executions.bin").string();
+    
+    cout << "Writing 1000000 synthetic executions" << endl;
+    vector<Execution> written;
+    written.reserve(1000000);
+    mt19937_64 rng(33);
+    int64_t ticks = 10000;
+    for (uint64_t match = 1; match <= 1000000; ++match) {
+        ticks += static_cast<int64_t>(rng() % 5) - 2;
+        OrderId resting = match * 3 - rng() % 200;
+        BuyOrSell aggressor = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+        written.push_back(Execution{match, match * 2 + rng() % 2, ticks * 0.01L, static_cast<Quantity>(1 + rng() % 500),
+                                    aggressor, aggressor == BuyOrSell::Buy ? match * 3 : resting,
+                                    aggressor == BuyOrSell::Buy ? resting : match * 3});
+    }
+    uint64_t bytes = 0;
+    auto start = chrono::steady_clock::now();
+    {
+        ExecutionLogWriter log(path, 0.01L, 4096);
+        for (const auto& execution : written) {
+            log.Append(execution);
+        }
+        log.Close();
+        bytes = log.BytesWritten();
+        check(log.Rows() == written.size() && !log.Failed(), "every execution written");
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    
+    // Same fills as printed by the interactive program
+    ostringstream text;
+    for (size_t i = 0; i < 1000; ++i) {
+        text << "TRADE EXECUTED: \n  Bid Order ID: " << written[i].bidOrderId << ", Price: " << fixed << setprecision(2)
+             << written[i].price << ", Quantity: " << written[i].quantity << "\n  Ask Order ID: " << written[i].askOrderId
+             << ", Price: " << written[i].price << ", Quantity: " << written[i].quantity << "\n";
+    }
+    double binaryPerRow = static_cast<double>(bytes) / written.size();
+    double textPerRow = static_cast<double>(text.str().size()) / 1000;
+    cout << "  " << elapsed.count() << " ms, " << binaryPerRow << " bytes per execution vs " << textPerRow << " as text" << endl;
+    check(binaryPerRow * 5 < textPerRow, "log is a fraction of the text output");
+    
+    ExecutionLogReader reader(path);
+    check(reader.Rows() == written.size(), "reader indexes every chunk");
+    vector<int64_t> quantities = reader.ReadColumn(ExecutionColumn::Quantity);
+    bool quantitiesMatch = quantities.size() == written.size();
+    for (size_t i = 0; quantitiesMatch && i < quantities.size(); ++i) {
+        quantitiesMatch = static_cast<Quantity>(quantities[i]) == written[i].quantity;
+    }
+    check(quantitiesMatch, "single column scan decodes on its own");
+    
+    vector<Execution> read = reader.ReadAll();
+    bool allMatch = read.size() == written.size();
+    for (size_t i = 0; allMatch && i < read.size(); ++i) {
+        allMatch = read[i].matchId == written[i].matchId && read[i].time == written[i].time &&
+                   fabsl(read[i].price - written[i].price) < 1e-9L && read[i].quantity == written[i].quantity &&
+                   read[i].aggressor == written[i].aggressor && read[i].bidOrderId == written[i].bidOrderId &&
+                   read[i].askOrderId == written[i].askOrderId;
+    }
+    check(allMatch, "every column round-trips");
+    
+    cout << "\nCutting the file short mid-chunk" << endl;
+    filesystem::resize_file(path, filesystem::file_size(path) - 100);
+    check(ExecutionLogReader(path).Rows() == written.size() - written.size() % 4096, "truncated chunk is ignored");
+    
+    cout << "\nLogging executions from a book" << endl;
+    {
+        Orderbook orderbook;
+        ExecutionLogWriter log(path, 0.01L);
+        orderbook.AttachExecutionLog(&log);
+        orderbook.WarmUp(10);
+        vector<pair<Trade, BuyOrSell>> trades;
+        for (OrderId id = 1; id <= 5000; ++id) {
+            BuyOrSell side = rng() % 2 ? BuyOrSell::Buy : BuyOrSell::Sell;
+            Price price = 99.90 + static_cast<int>(rng() % 20) * 0.01;
+            orderbook.AdvanceTime(id);
+            for (const auto& trade : orderbook.AddOrder(make_shared<Order>(OrderType::GoodTillCancel, id, side, price, 1 + rng() % 50))) {
+                trades.emplace_back(trade, side);
+            }
+        }
+        log.Close();
+        
+        vector<Execution> logged = ExecutionLogReader(path).ReadAll();
+        bool same = logged.size() == trades.size() && !trades.empty();
+        for (size_t i = 0; same && i < logged.size(); ++i) {
+            const Trade& trade = trades[i].first;
+            same = logged[i].matchId == i + 1 && logged[i].aggressor == trades[i].second &&
+                   logged[i].bidOrderId == trade.GetBidTrade().orderid && logged[i].askOrderId == trade.GetAskTrade().orderid &&
+                   logged[i].quantity == trade.GetBidTrade().quantity;
+        }
+        check(same, "log matches the trades returned, warm-up excluded");
+    }
+    filesystem::remove(path);
+}
+
+// Test the work-stealing pool and the parallel backtest runner
+void testBacktestRunner() {
+    cout << "\n===== TESTING BACKTEST RUNNER =====\n" << endl;
+    
+    cout << "Running 1000 tasks, each submitting 10 more, on 4 workers" << endl;
+    {
+        atomic<int> done{0};
+        ThreadPool pool(4);
+        for (int task = 0; task < 1000; ++task) {
+            pool.Submit([&pool, &done] {
+                for (int child = 0; child < 10; ++child) {
+                    pool.Submit([&done] { ++done; });
+                }
+                ++done;
+            });
+        }
+        pool.Wait();
+        cout << "  Steals: " << pool.Steals() << endl;
+        check(done == 11000, "every task and nested task ran before Wait returned");
+    }
+    
+    cout << "\nReplaying 8 generated sessions on 1 and 4 threads" << endl;
+    BacktestConfig config;
+    config.eventsPerSeed = 20000;
+    vector<SessionSource> seeds;
+    for (uint64_t seed = 1; seed <= 8; ++seed) {
+        seeds.push_back(SessionSource::FromSeed(seed));
+    }
+    config.threads = 1;
+    BacktestSummary serial = RunBacktest(seeds, config);
+    config.threads = 4;
+    BacktestSummary parallel = RunBacktest(seeds, config);
+    PrintBacktestReport(cout, parallel, false);
+    bool same = serial.trades == parallel.trades && serial.volume == parallel.volume && serial.vwap == parallel.vwap;
+    for (size_t i = 0; same && i < seeds.size(); ++i) {
+        same = serial.sessions[i].statistics.tradeCount == parallel.sessions[i].statistics.tradeCount &&
+               serial.sessions[i].restingOrders == parallel.sessions[i].restingOrders;
+    }
+    check(parallel.failed == 0 && parallel.trades > 0 && parallel.events == 8 * 20000, "all sessions replayed");
+    check(same, "results do not depend on the thread count");
+    
+    cout << "\nReplaying session files" << endl;
+    string good = (filesystem::temp_directory_path() / "orderbook_test_session.txt").string();
+    string bad = (filesystem::temp_directory_path() / "orderbook_test_bad_session.txt").string();
+    {
+        ofstream out(good);
+        out << "# Recorded session\n"
+            << "session 1000\n"
+            << "add 1 sell 100.00 10\n"
+            << "add 2 buy 100.50 4      # Trades 4 at 100.00\n"
+            << "add 3 buy 99.00 5 GTT 50\n"
+            << "\n"
+            << "time 60\n"
+            << "add 4 sell 99.00 3 FAK\n"
+            << "modify 1 sell 100.00 8\n"
+            << "cancel 1\n"
+            << "add 5 buy 100.00 2\n";
+        ofstream badOut(bad);
+        badOut << "add 1 sell 100.00 10\nbogus 2\n";
+    }
+    BacktestSummary files = RunBacktest({SessionSource::FromFile(good), SessionSource::FromFile(bad),
+                                         SessionSource::FromFile(bad + ".missing")}, config);
+    PrintBacktestReport(cout, files, true);
+    const SessionResult& session = files.sessions[0];
+    check(session.error.empty() && session.events == 9 && session.cancels == 1, "session file replayed");
+    check(session.statistics.tradeCount == 1 && session.statistics.volume == 4 && session.restingOrders == 1,
+          "session statistics merged from the book");
+    check(files.failed == 2 && files.sessions[1].error.find(":2:") != string::npos, "bad and missing files reported");
+    filesystem::remove(good);
+    filesystem::remove(bad);
+}
+
 int main() {
     try {
         cout << "\n======================================================" << endl;
@@ -216,6 +932,33 @@ int main() {
         // Test order matching functionality
         testOrderMatching();
         
+        // Test timed order expiry
+        testTimedOrders();
+        
+        // Test the dense price ladder
+        testDensePriceLadder();
+        
+        // Test concurrent snapshot readers
+        testConcurrentSnapshots();
+        
+        // Test capacity reservation and warm-up
+        testCapacityAndWarmUp();
+        
+        // Test trade statistics and bars
+        testTradeBars();
+        
+        // Test matching policies
+        testMatchingPolicies();
+        
+        // Test lazy cancellation
+        testLazyCancel();
+        
+        // Test the execution log
+        testExecutionLog();
+        
+        // Test the backtest runner
+        testBacktestRunner();
+        
         cout << "\n======================================================" << endl;
         cout << "           ALL TESTS COMPLETED SUCCESSFULLY           " << endl;
         cout << "======================================================\n" << endl;